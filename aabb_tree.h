@@ -0,0 +1,395 @@
+#pragma once
+
+#include "raylib.h"
+
+#include "broadphase.h"
+#include "circle_pool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Dynamic AABB tree broadphase, suited to widely mixed circle radii
+// Every circle owns a leaf with a fattened box; a step only reinserts the leaves whose circle
+// left its fat box and refits their ancestors, the tree is never rebuilt from scratch. Inserts
+// pick the sibling with the surface area heuristic and the tree is kept balanced with rotations
+// NOTE: Leaves are keyed by the circle handle, so they survive despawns and Morton reordering
+class AabbTree : public Broadphase
+{
+public:
+    float margin = 2.0f;                // Fat box growth (pixels), larger means fewer reinserts but more candidate pairs
+    float prediction = 0.1f;            // Fat box is also stretched along the velocity over this time (seconds)
+
+    const char *Name() const override { return "AABB tree"; }
+
+    void Update(const CirclePool &circles, float width, float height) override
+    {
+        (void)width;
+        (void)height;
+
+        stamp++;
+
+        for (size_t i = 0; i < circles.Size(); i++)
+        {
+            CircleHandle handle = circles.HandleAt(i);
+            if (handle.index >= slotLeaf.size()) slotLeaf.resize(handle.index + 1, nullNode);
+
+            int leaf = slotLeaf[handle.index];
+            Box tight = CircleBox(circles, i);
+
+            // The slot was recycled by a new circle since the last update
+            if ((leaf != nullNode) && (nodes[leaf].generation != handle.generation))
+            {
+                DestroyLeaf(leaf);
+                leaf = nullNode;
+            }
+
+            if (leaf == nullNode)
+            {
+                leaf = AllocateNode();
+                nodes[leaf].box = Fatten(tight, circles.velocities[i]);
+                nodes[leaf].slot = handle.index;
+                nodes[leaf].generation = handle.generation;
+                InsertLeaf(leaf);
+
+                slotLeaf[handle.index] = leaf;
+                leafCount++;
+            }
+            else if (!Contains(nodes[leaf].box, tight))
+            {
+                RemoveLeaf(leaf);
+                nodes[leaf].box = Fatten(tight, circles.velocities[i]);
+                InsertLeaf(leaf);
+            }
+
+            nodes[leaf].dense = (uint32_t)i;
+            nodes[leaf].stamp = stamp;
+        }
+
+        // Drop the leaves of despawned circles
+        if (leafCount > circles.Size())
+        {
+            for (size_t slot = 0; slot < slotLeaf.size(); slot++)
+            {
+                int leaf = slotLeaf[slot];
+                if ((leaf != nullNode) && (nodes[leaf].stamp != stamp)) DestroyLeaf(leaf);
+            }
+        }
+    }
+
+    // Self-collision traversal of the tree: each subtree is tested against itself and pairs of
+    // sibling subtrees against each other, so every overlapping leaf pair is met exactly once
+    void FindPairs(const CirclePool &circles, std::vector<CirclePair> &pairs) override
+    {
+        pairs.clear();
+        if ((root == nullNode) || nodes[root].IsLeaf()) return;
+
+        stack.clear();
+        stack.push_back({ root, root });
+
+        while (!stack.empty())
+        {
+            NodePair current = stack.back();
+            stack.pop_back();
+
+            const Node &a = nodes[current.a];
+            const Node &b = nodes[current.b];
+
+            if (current.a == current.b)
+            {
+                // Pairs inside one subtree: within each child and across the two children
+                if (a.IsLeaf()) continue;
+
+                stack.push_back({ a.child1, a.child1 });
+                stack.push_back({ a.child2, a.child2 });
+                stack.push_back({ a.child1, a.child2 });
+            }
+            else if (Overlaps(a.box, b.box))
+            {
+                if (a.IsLeaf() && b.IsLeaf()) TestPair(circles, a.dense, b.dense, pairs);
+                else if (b.IsLeaf() || (!a.IsLeaf() && (Perimeter(a.box) > Perimeter(b.box))))
+                {
+                    // Descend the larger subtree
+                    stack.push_back({ a.child1, current.b });
+                    stack.push_back({ a.child2, current.b });
+                }
+                else
+                {
+                    stack.push_back({ current.a, b.child1 });
+                    stack.push_back({ current.a, b.child2 });
+                }
+            }
+        }
+    }
+
+    int Height() const { return (root == nullNode)? 0 : nodes[root].height; }
+
+private:
+    static constexpr int nullNode = -1;
+
+    struct Box
+    {
+        float minX, minY, maxX, maxY;
+    };
+
+    struct NodePair
+    {
+        int a;
+        int b;
+    };
+
+    struct Node
+    {
+        Box box;
+        int parent;                     // Next free node while in the free list
+        int child1;
+        int child2;
+        int height;                     // 0 for leaves, -1 for free nodes
+
+        // Leaves only
+        uint32_t dense;                 // Dense index of the circle at the last update
+        uint32_t slot;
+        uint32_t generation;
+        uint32_t stamp;                 // Last update that saw the circle
+
+        bool IsLeaf() const { return child1 == nullNode; }
+    };
+
+    static Box CircleBox(const CirclePool &circles, size_t i)
+    {
+        Vector2 p = circles.positions[i];
+        float r = circles.radii[i];
+        return { p.x - r, p.y - r, p.x + r, p.y + r };
+    }
+
+    Box Fatten(Box box, Vector2 velocity) const
+    {
+        float dx = velocity.x*prediction;
+        float dy = velocity.y*prediction;
+
+        box = { box.minX - margin, box.minY - margin, box.maxX + margin, box.maxY + margin };
+        if (dx < 0.0f) box.minX += dx; else box.maxX += dx;
+        if (dy < 0.0f) box.minY += dy; else box.maxY += dy;
+
+        return box;
+    }
+
+    static Box Union(const Box &a, const Box &b)
+    {
+        return { fminf(a.minX, b.minX), fminf(a.minY, b.minY), fmaxf(a.maxX, b.maxX), fmaxf(a.maxY, b.maxY) };
+    }
+
+    static float Perimeter(const Box &box) { return 2.0f*((box.maxX - box.minX) + (box.maxY - box.minY)); }
+
+    static bool Contains(const Box &outer, const Box &inner)
+    {
+        return (outer.minX <= inner.minX) && (outer.minY <= inner.minY) && (outer.maxX >= inner.maxX) && (outer.maxY >= inner.maxY);
+    }
+
+    static bool Overlaps(const Box &a, const Box &b)
+    {
+        return (a.minX < b.maxX) && (b.minX < a.maxX) && (a.minY < b.maxY) && (b.minY < a.maxY);
+    }
+
+    int AllocateNode()
+    {
+        if (freeList == nullNode)
+        {
+            nodes.push_back({});
+            nodes.back().parent = nullNode;
+            freeList = (int)nodes.size() - 1;
+        }
+
+        int index = freeList;
+        freeList = nodes[index].parent;
+
+        nodes[index].parent = nullNode;
+        nodes[index].child1 = nullNode;
+        nodes[index].child2 = nullNode;
+        nodes[index].height = 0;
+        return index;
+    }
+
+    void FreeNode(int index)
+    {
+        nodes[index].parent = freeList;
+        nodes[index].height = -1;
+        freeList = index;
+    }
+
+    void DestroyLeaf(int leaf)
+    {
+        slotLeaf[nodes[leaf].slot] = nullNode;
+        RemoveLeaf(leaf);
+        FreeNode(leaf);
+        leafCount--;
+    }
+
+    void InsertLeaf(int leaf)
+    {
+        if (root == nullNode)
+        {
+            root = leaf;
+            nodes[root].parent = nullNode;
+            return;
+        }
+
+        // Descend to the sibling that minimizes the added perimeter (surface area heuristic)
+        Box leafBox = nodes[leaf].box;
+        int index = root;
+
+        while (!nodes[index].IsLeaf())
+        {
+            int child1 = nodes[index].child1;
+            int child2 = nodes[index].child2;
+
+            float area = Perimeter(nodes[index].box);
+            float combinedArea = Perimeter(Union(nodes[index].box, leafBox));
+
+            float cost = 2.0f*combinedArea;                     // New parent for this node and the leaf
+            float inheritanceCost = 2.0f*(combinedArea - area); // Minimum cost of pushing the leaf further down
+
+            float cost1 = ChildCost(child1, leafBox) + inheritanceCost;
+            float cost2 = ChildCost(child2, leafBox) + inheritanceCost;
+
+            if ((cost < cost1) && (cost < cost2)) break;
+
+            index = (cost1 < cost2)? child1 : child2;
+        }
+
+        int sibling = index;
+        int oldParent = nodes[sibling].parent;
+        int newParent = AllocateNode();
+
+        nodes[newParent].parent = oldParent;
+        nodes[newParent].box = Union(leafBox, nodes[sibling].box);
+        nodes[newParent].height = nodes[sibling].height + 1;
+        nodes[newParent].child1 = sibling;
+        nodes[newParent].child2 = leaf;
+        nodes[sibling].parent = newParent;
+        nodes[leaf].parent = newParent;
+
+        if (oldParent != nullNode)
+        {
+            if (nodes[oldParent].child1 == sibling) nodes[oldParent].child1 = newParent;
+            else nodes[oldParent].child2 = newParent;
+        }
+        else root = newParent;
+
+        Refit(nodes[leaf].parent);
+    }
+
+    float ChildCost(int child, const Box &leafBox) const
+    {
+        Box box = Union(leafBox, nodes[child].box);
+        if (nodes[child].IsLeaf()) return Perimeter(box);
+        return Perimeter(box) - Perimeter(nodes[child].box);
+    }
+
+    void RemoveLeaf(int leaf)
+    {
+        if (leaf == root)
+        {
+            root = nullNode;
+            return;
+        }
+
+        int parent = nodes[leaf].parent;
+        int grandParent = nodes[parent].parent;
+        int sibling = (nodes[parent].child1 == leaf)? nodes[parent].child2 : nodes[parent].child1;
+
+        if (grandParent != nullNode)
+        {
+            if (nodes[grandParent].child1 == parent) nodes[grandParent].child1 = sibling;
+            else nodes[grandParent].child2 = sibling;
+
+            nodes[sibling].parent = grandParent;
+            FreeNode(parent);
+            Refit(grandParent);
+        }
+        else
+        {
+            root = sibling;
+            nodes[sibling].parent = nullNode;
+            FreeNode(parent);
+        }
+    }
+
+    // Walk up from index, rebalancing and refitting boxes and heights
+    void Refit(int index)
+    {
+        while (index != nullNode)
+        {
+            index = Balance(index);
+
+            int child1 = nodes[index].child1;
+            int child2 = nodes[index].child2;
+
+            nodes[index].height = 1 + std::max(nodes[child1].height, nodes[child2].height);
+            nodes[index].box = Union(nodes[child1].box, nodes[child2].box);
+
+            index = nodes[index].parent;
+        }
+    }
+
+    // Rotate a grandchild up if the subtree at a is imbalanced, returns the new subtree root
+    int Balance(int a)
+    {
+        Node &nodeA = nodes[a];
+        if (nodeA.IsLeaf() || (nodeA.height < 2)) return a;
+
+        int b = nodeA.child1;
+        int c = nodeA.child2;
+        int balance = nodes[c].height - nodes[b].height;
+
+        if (balance > 1) return Rotate(a, c, b);
+        if (balance < -1) return Rotate(a, b, c);
+
+        return a;
+    }
+
+    // Promote high (the taller child of a) in place of a; other is the shorter child of a
+    int Rotate(int a, int high, int other)
+    {
+        int f = nodes[high].child1;
+        int g = nodes[high].child2;
+
+        // Swap a and high
+        nodes[high].child1 = a;
+        nodes[high].parent = nodes[a].parent;
+        nodes[a].parent = high;
+
+        int highParent = nodes[high].parent;
+        if (highParent != nullNode)
+        {
+            if (nodes[highParent].child1 == a) nodes[highParent].child1 = high;
+            else nodes[highParent].child2 = high;
+        }
+        else root = high;
+
+        // Keep the taller grandchild under high, move the other one under a
+        int keep = (nodes[f].height > nodes[g].height)? f : g;
+        int move = (keep == f)? g : f;
+
+        nodes[high].child2 = keep;
+        nodes[a].child1 = other;
+        nodes[a].child2 = move;
+        nodes[move].parent = a;
+
+        nodes[a].box = Union(nodes[other].box, nodes[move].box);
+        nodes[high].box = Union(nodes[a].box, nodes[keep].box);
+        nodes[a].height = 1 + std::max(nodes[other].height, nodes[move].height);
+        nodes[high].height = 1 + std::max(nodes[a].height, nodes[keep].height);
+
+        return high;
+    }
+
+    std::vector<Node> nodes;
+    std::vector<int> slotLeaf;          // Leaf of each circle pool slot, nullNode when none
+    std::vector<NodePair> stack;        // Traversal stack, reused between steps
+    int root = nullNode;
+    int freeList = nullNode;
+    size_t leafCount = 0;
+    uint32_t stamp = 0;
+};
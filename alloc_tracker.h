@@ -0,0 +1,411 @@
+#pragma once
+
+// Allocation tracking for the instrumented build (build.bat -DTRACK_ALLOCATIONS)
+//
+// Counts allocations, bytes and call sites per frame for:
+//   - our code: global operator new/delete are replaced (std::vector, std::thread, ...)
+//   - raylib: TrackedMalloc/TrackedCalloc/TrackedRealloc/TrackedFree are plugged into raylib's
+//     custom allocator macros, which requires recompiling raylib sources with:
+//       -DRL_MALLOC(sz)=TrackedMalloc(sz) -DRL_CALLOC(n,sz)=TrackedCalloc(n,sz)
+//       -DRL_REALLOC(ptr,sz)=TrackedRealloc(ptr,sz) -DRL_FREE(ptr)=TrackedFree(ptr)
+//     With the prebuilt libs/raylib binaries only our own allocations are visible
+//
+// Frames are bracketed with AllocTrackerBeginFrame()/AllocTrackerEndFrame(); any allocation
+// inside a frame flagged as steady state is reported with its call sites through TraceLog()
+// A call site is the chain of return addresses above the allocator, innermost first, so an
+// allocation made inside std::vector or std::string still reaches the frame of our code that
+// triggered it; resolve them with: addr2line -f -C -e <exe> <addresses>
+// NOTE: The chain is walked with the unwind tables (GCC/MinGW _Unwind_Backtrace) and is cut at
+// allocStackDepth frames, deep library call chains may need a larger depth
+//
+// Exactly one translation unit must #define ALLOC_TRACKER_IMPLEMENTATION before including
+// this header. Without TRACK_ALLOCATIONS every function is an empty inline stub
+
+#include <cstddef>
+#include <cstdint>
+
+enum AllocSource {
+    ALLOC_SOURCE_APP = 0,               // Our code, through operator new
+    ALLOC_SOURCE_RAYLIB,                // raylib internals, through RL_MALLOC and friends
+    ALLOC_SOURCE_COUNT
+};
+
+// Allocation counters for one frame
+struct AllocFrameStats
+{
+    uint64_t allocations[ALLOC_SOURCE_COUNT];
+    uint64_t frees[ALLOC_SOURCE_COUNT];
+    uint64_t bytes[ALLOC_SOURCE_COUNT];     // Bytes requested by this frame allocations
+    uint64_t liveBytes;                     // Bytes still allocated at the end of the frame
+};
+
+extern "C" {
+void *TrackedMalloc(size_t size);
+void *TrackedCalloc(size_t count, size_t size);
+void *TrackedRealloc(void *ptr, size_t size);
+void TrackedFree(void *ptr);
+}
+
+#if defined(TRACK_ALLOCATIONS)
+
+void AllocTrackerBeginFrame(bool steadyState);      // Reset frame counters, steadyState flags any allocation
+AllocFrameStats AllocTrackerEndFrame(void);         // Collect frame counters, report call sites if flagged
+
+#else
+
+inline void AllocTrackerBeginFrame(bool) { }
+inline AllocFrameStats AllocTrackerEndFrame(void) { return {}; }
+
+#endif
+
+//----------------------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------------------
+#if defined(ALLOC_TRACKER_IMPLEMENTATION)
+
+#include "raylib.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#if defined(TRACK_ALLOCATIONS)
+
+#if defined(__GNUC__)
+    #include <unwind.h>
+    #define ALLOC_NOINLINE __attribute__((noinline))
+#else
+    #define ALLOC_NOINLINE
+#endif
+
+namespace {
+
+constexpr int maxCallSites = 256;       // Fixed table, the tracker itself must never allocate
+constexpr int allocStackDepth = 8;      // Return addresses kept per call site, -O0 STL chains are deep
+constexpr int allocStackSkip = 2;       // CaptureAllocStack() and TrackAlloc()
+
+struct AllocStack
+{
+    const void *frames[allocStackDepth];
+    int count;
+};
+
+struct AllocHeader
+{
+    void *raw;                          // Pointer returned by malloc
+    size_t size;                        // Requested size
+};
+
+// Frames are written once by the thread that claims the slot, then published through ready
+struct AllocCallSite
+{
+    std::atomic<uint64_t> key;          // Hash of the frames, 0 for a free slot
+    std::atomic<bool> ready;
+    const void *frames[allocStackDepth];
+    int frameCount;
+    std::atomic<uint32_t> count;
+    std::atomic<uint64_t> bytes;
+    std::atomic<int> source;
+};
+
+struct AllocCallSiteTable
+{
+    AllocCallSite sites[maxCallSites];
+    std::atomic<int> writers;           // Threads currently recording into the table
+};
+
+struct AllocTrackerState
+{
+    std::atomic<uint64_t> allocations[ALLOC_SOURCE_COUNT];
+    std::atomic<uint64_t> frees[ALLOC_SOURCE_COUNT];
+    std::atomic<uint64_t> bytes[ALLOC_SOURCE_COUNT];
+    std::atomic<int64_t> liveBytes;
+    std::atomic<bool> recordCallSites;
+    std::atomic<bool> steadyState;
+
+    // Call sites are recorded into the table selected by the frame epoch parity; a new frame
+    // clears the other table, once no thread is left recording into it, then flips the epoch
+    AllocCallSiteTable callSiteTables[2];
+    std::atomic<uint32_t> callSiteEpoch;
+};
+
+AllocTrackerState allocTracker = {};
+
+thread_local bool capturingStack = false;   // The unwinder must not recurse into the tracker
+
+#if defined(__GNUC__)
+struct AllocUnwindState
+{
+    AllocStack *stack;
+    int skip;
+};
+
+_Unwind_Reason_Code AllocUnwindFrame(struct _Unwind_Context *context, void *arg)
+{
+    AllocUnwindState *state = (AllocUnwindState *)arg;
+    if (state->skip > 0)
+    {
+        state->skip--;
+        return _URC_NO_REASON;
+    }
+
+    state->stack->frames[state->stack->count++] = (const void *)_Unwind_GetIP(context);
+    return (state->stack->count < allocStackDepth)? _URC_NO_REASON : _URC_END_OF_STACK;
+}
+#endif
+
+// Return addresses of the allocating call chain, innermost first, tracker frames skipped
+ALLOC_NOINLINE void CaptureAllocStack(AllocStack &stack)
+{
+    stack.count = 0;
+    if (capturingStack) return;
+
+    capturingStack = true;
+#if defined(__GNUC__)
+    AllocUnwindState state = { &stack, allocStackSkip };
+    _Unwind_Backtrace(AllocUnwindFrame, &state);
+#endif
+    capturingStack = false;
+}
+
+void RecordCallSite(const AllocStack &stack, size_t size, AllocSource source)
+{
+    uint32_t epoch = allocTracker.callSiteEpoch.load();
+    AllocCallSiteTable &table = allocTracker.callSiteTables[epoch & 1];
+
+    // A frame started in between and may be clearing this table, drop the sample
+    table.writers.fetch_add(1);
+    if (allocTracker.callSiteEpoch.load() != epoch)
+    {
+        table.writers.fetch_sub(1);
+        return;
+    }
+
+    // Open addressing on the hashed frames (FNV-1a), sites past the table capacity are dropped
+    uint64_t key = 14695981039346656037ull;
+    for (int i = 0; i < stack.count; i++) key = (key ^ (uintptr_t)stack.frames[i])*1099511628211ull;
+    key |= 1;
+
+    for (int probe = 0; probe < maxCallSites; probe++)
+    {
+        AllocCallSite &site = table.sites[(key + probe)%maxCallSites];
+        uint64_t expected = 0;
+
+        if (site.key.compare_exchange_strong(expected, key))
+        {
+            memcpy(site.frames, stack.frames, stack.count*sizeof(const void *));
+            site.frameCount = stack.count;
+            site.source.store(source, std::memory_order_relaxed);
+            site.ready.store(true, std::memory_order_release);
+        }
+        else if (expected != key) continue;
+
+        site.count.fetch_add(1, std::memory_order_relaxed);
+        site.bytes.fetch_add(size, std::memory_order_relaxed);
+        break;
+    }
+
+    table.writers.fetch_sub(1, std::memory_order_release);
+}
+
+ALLOC_NOINLINE void *TrackAlloc(size_t size, size_t alignment, AllocSource source)
+{
+    if (alignment < alignof(std::max_align_t)) alignment = alignof(std::max_align_t);
+
+    void *raw = std::malloc(size + alignment + sizeof(AllocHeader));
+    if (raw == nullptr) return nullptr;
+
+    uintptr_t user = ((uintptr_t)raw + sizeof(AllocHeader) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    AllocHeader *header = (AllocHeader *)user - 1;
+    header->raw = raw;
+    header->size = size;
+
+    allocTracker.allocations[source].fetch_add(1, std::memory_order_relaxed);
+    allocTracker.bytes[source].fetch_add(size, std::memory_order_relaxed);
+    allocTracker.liveBytes.fetch_add((int64_t)size, std::memory_order_relaxed);
+    if (allocTracker.recordCallSites.load(std::memory_order_relaxed))
+    {
+        AllocStack stack;
+        CaptureAllocStack(stack);
+        RecordCallSite(stack, size, source);
+    }
+
+    return (void *)user;
+}
+
+// operator new semantics: on failure call the installed new-handler and retry, throw once none is left
+void *TrackNew(size_t size, size_t alignment)
+{
+    for (;;)
+    {
+        void *ptr = TrackAlloc(size, alignment, ALLOC_SOURCE_APP);
+        if (ptr != nullptr) return ptr;
+
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void TrackFree(void *ptr, AllocSource source)
+{
+    if (ptr == nullptr) return;
+
+    AllocHeader *header = (AllocHeader *)ptr - 1;
+
+    allocTracker.frees[source].fetch_add(1, std::memory_order_relaxed);
+    allocTracker.liveBytes.fetch_sub((int64_t)header->size, std::memory_order_relaxed);
+
+    std::free(header->raw);
+}
+
+} // namespace
+
+void AllocTrackerBeginFrame(bool steadyState)
+{
+    for (int i = 0; i < ALLOC_SOURCE_COUNT; i++)
+    {
+        allocTracker.allocations[i].store(0, std::memory_order_relaxed);
+        allocTracker.frees[i].store(0, std::memory_order_relaxed);
+        allocTracker.bytes[i].store(0, std::memory_order_relaxed);
+    }
+
+    // Threads still holding the idle table read the epoch two frames ago, they leave it shortly
+    uint32_t epoch = allocTracker.callSiteEpoch.load();
+    AllocCallSiteTable &idle = allocTracker.callSiteTables[(epoch + 1) & 1];
+    while (idle.writers.load(std::memory_order_acquire) != 0) std::this_thread::yield();
+
+    for (AllocCallSite &site : idle.sites)
+    {
+        site.key.store(0, std::memory_order_relaxed);
+        site.ready.store(false, std::memory_order_relaxed);
+        site.count.store(0, std::memory_order_relaxed);
+        site.bytes.store(0, std::memory_order_relaxed);
+    }
+
+    allocTracker.callSiteEpoch.store(epoch + 1);
+    allocTracker.steadyState.store(steadyState, std::memory_order_relaxed);
+    allocTracker.recordCallSites.store(true, std::memory_order_relaxed);
+}
+
+AllocFrameStats AllocTrackerEndFrame(void)
+{
+    allocTracker.recordCallSites.store(false, std::memory_order_relaxed);
+
+    AllocFrameStats stats = {};
+    uint64_t total = 0;
+
+    for (int i = 0; i < ALLOC_SOURCE_COUNT; i++)
+    {
+        stats.allocations[i] = allocTracker.allocations[i].load(std::memory_order_relaxed);
+        stats.frees[i] = allocTracker.frees[i].load(std::memory_order_relaxed);
+        stats.bytes[i] = allocTracker.bytes[i].load(std::memory_order_relaxed);
+        total += stats.allocations[i];
+    }
+
+    int64_t live = allocTracker.liveBytes.load(std::memory_order_relaxed);
+    stats.liveBytes = (live > 0)? (uint64_t)live : 0;
+
+    if (allocTracker.steadyState.load(std::memory_order_relaxed) && (total > 0))
+    {
+        TraceLog(LOG_WARNING, "ALLOC: %llu allocations in steady-state frame (app: %llu, raylib: %llu)",
+            (unsigned long long)total, (unsigned long long)stats.allocations[ALLOC_SOURCE_APP],
+            (unsigned long long)stats.allocations[ALLOC_SOURCE_RAYLIB]);
+
+        const AllocCallSiteTable &table = allocTracker.callSiteTables[allocTracker.callSiteEpoch.load() & 1];
+
+        for (const AllocCallSite &site : table.sites)
+        {
+            if (!site.ready.load(std::memory_order_acquire)) continue;
+
+            // Innermost frame first, e.g. std::vector internals <- our code
+            char chain[allocStackDepth*24] = "";
+            int length = 0;
+            for (int i = 0; (i < site.frameCount) && (length < (int)sizeof(chain)); i++)
+            {
+                length += snprintf(chain + length, sizeof(chain) - length, (i == 0)? "%p" : " <- %p", site.frames[i]);
+            }
+
+            TraceLog(LOG_WARNING, "ALLOC:     [%s] %s: %u allocations, %llu bytes",
+                (site.source.load(std::memory_order_relaxed) == ALLOC_SOURCE_RAYLIB)? "raylib" : "app",
+                chain, site.count.load(std::memory_order_relaxed),
+                (unsigned long long)site.bytes.load(std::memory_order_relaxed));
+        }
+    }
+
+    return stats;
+}
+
+extern "C" {
+
+void *TrackedMalloc(size_t size) { return TrackAlloc(size, 0, ALLOC_SOURCE_RAYLIB); }
+
+void *TrackedCalloc(size_t count, size_t size)
+{
+    void *ptr = TrackAlloc(count*size, 0, ALLOC_SOURCE_RAYLIB);
+    if (ptr != nullptr) std::memset(ptr, 0, count*size);
+    return ptr;
+}
+
+void *TrackedRealloc(void *ptr, size_t size)
+{
+    void *result = TrackAlloc(size, 0, ALLOC_SOURCE_RAYLIB);
+
+    if ((ptr != nullptr) && (result != nullptr))
+    {
+        size_t oldSize = ((AllocHeader *)ptr - 1)->size;
+        std::memcpy(result, ptr, (oldSize < size)? oldSize : size);
+    }
+
+    if (result != nullptr) TrackFree(ptr, ALLOC_SOURCE_RAYLIB);
+    return result;
+}
+
+void TrackedFree(void *ptr) { TrackFree(ptr, ALLOC_SOURCE_RAYLIB); }
+
+}
+
+void *operator new(size_t size) { return TrackNew(size, 0); }
+void *operator new[](size_t size) { return TrackNew(size, 0); }
+void *operator new(size_t size, std::align_val_t alignment) { return TrackNew(size, (size_t)alignment); }
+void *operator new[](size_t size, std::align_val_t alignment) { return TrackNew(size, (size_t)alignment); }
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    try { return TrackNew(size, 0); }
+    catch (const std::bad_alloc &) { return nullptr; }
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    try { return TrackNew(size, 0); }
+    catch (const std::bad_alloc &) { return nullptr; }
+}
+
+void operator delete(void *ptr) noexcept { TrackFree(ptr, ALLOC_SOURCE_APP); }
+void operator delete[](void *ptr) noexcept { TrackFree(ptr, ALLOC_SOURCE_APP); }
+void operator delete(void *ptr, size_t) noexcept { TrackFree(ptr, ALLOC_SOURCE_APP); }
+void operator delete[](void *ptr, size_t) noexcept { TrackFree(ptr, ALLOC_SOURCE_APP); }
+void operator delete(void *ptr, std::align_val_t) noexcept { TrackFree(ptr, ALLOC_SOURCE_APP); }
+void operator delete[](void *ptr, std::align_val_t) noexcept { TrackFree(ptr, ALLOC_SOURCE_APP); }
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept { TrackFree(ptr, ALLOC_SOURCE_APP); }
+void operator delete[](void *ptr, size_t, std::align_val_t) noexcept { TrackFree(ptr, ALLOC_SOURCE_APP); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept { TrackFree(ptr, ALLOC_SOURCE_APP); }
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept { TrackFree(ptr, ALLOC_SOURCE_APP); }
+
+#else
+
+// Plain pass-through so a raylib built against the hooks still links in regular builds
+extern "C" {
+void *TrackedMalloc(size_t size) { return std::malloc(size); }
+void *TrackedCalloc(size_t count, size_t size) { return std::calloc(count, size); }
+void *TrackedRealloc(void *ptr, size_t size) { return std::realloc(ptr, size); }
+void TrackedFree(void *ptr) { std::free(ptr); }
+}
+
+#endif // TRACK_ALLOCATIONS
+
+#endif // ALLOC_TRACKER_IMPLEMENTATION
@@ -0,0 +1,378 @@
+#pragma once
+
+#include "raylib.h"
+
+#include "circle_pool.h"
+#include "float4.h"
+#include "spatial_sort.h"
+#include "thread_pool.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Mutual gravity between all circles, Barnes-Hut approximation on a Morton-ordered quadtree
+// Bodies are sorted by Morton code, so every quadtree cell is a contiguous range of sorted
+// bodies and a cell's children are found by binary search on the next two code bits. The top
+// levels are built serially, the subtrees below them are built in parallel and then concatenated.
+// Forces are evaluated per leaf rather than per body: each leaf walks the tree once against its
+// bounding box, accepting cells with size < theta*distance as point masses and collecting the
+// bodies of opened leaves, then every body of the leaf sums that shared interaction list four
+// sources at a time with Float4
+// NOTE: Masses are proportional to circle area; theta = 0 degenerates to exact O(N^2) summation
+class BarnesHutGravity
+{
+public:
+    float theta = 0.7f;                 // Opening angle, larger is faster and coarser (cells holding the leaf are always opened)
+    float gravitationalConstant = 2000.0f;
+    float softening = 10.0f;            // Plummer softening length (pixels), bounds close encounter forces
+
+    static constexpr int leafSize = 32; // Most bodies in a leaf (except at the deepest level), leaves are also the
+                                        // force evaluation groups: larger ones amortize the tree walk over more bodies
+    static constexpr int maxLevel = 16; // 32-bit Morton codes, two bits per level
+
+    // Add the gravitational acceleration of every other circle to each circle acceleration
+    void Accumulate(CirclePool &circles, ThreadPool *pool = nullptr)
+    {
+        size_t count = circles.Size();
+        if (count < 2) return;
+
+        {
+            TRACE_SCOPE("GravitySort");
+            SortBodies(circles, pool);
+        }
+
+        {
+            TRACE_SCOPE("GravityBuild");
+            BuildTree(pool);
+        }
+
+        auto evaluate = [&](size_t begin, size_t end) {
+            for (size_t leaf = begin; leaf < end; leaf++) EvaluateLeaf(leaves[leaf], circles.accelerations.data());
+        };
+
+        if (pool != nullptr) pool->ParallelFor("GravityForces", leaves.size(), 16, evaluate);
+        else
+        {
+            TRACE_SCOPE("GravityForces");
+            evaluate(0, leaves.size());
+        }
+    }
+
+    size_t NodeCount() const { return nodes.size(); }
+
+private:
+    struct Node
+    {
+        float centerX;                  // Center of mass
+        float centerY;
+        float mass;
+        float size;                     // Cell width
+        uint32_t firstChild;            // Children are consecutive, childCount == 0 for leaves
+        uint32_t childCount;
+        uint32_t begin;                 // Sorted body range
+        uint32_t end;
+    };
+
+    struct Subtree
+    {
+        uint32_t node;                  // Placeholder in the top level nodes
+        uint32_t begin;
+        uint32_t end;
+        int level;
+        float size;
+        std::vector<Node> nodes;        // Built in parallel, root first; kept between steps
+    };
+
+    static constexpr int subtreeLevel = 3;      // Up to 64 parallel subtrees
+
+    void SortBodies(const CirclePool &circles, ThreadPool *pool)
+    {
+        size_t count = circles.Size();
+
+        float minX = circles.positions[0].x, minY = circles.positions[0].y;
+        float maxX = minX, maxY = minY;
+        for (size_t i = 1; i < count; i++)
+        {
+            Vector2 p = circles.positions[i];
+            minX = fminf(minX, p.x); maxX = fmaxf(maxX, p.x);
+            minY = fminf(minY, p.y); maxY = fmaxf(maxY, p.y);
+        }
+
+        // Square root cell, so every cell of a level has the same size
+        rootSize = fmaxf(fmaxf(maxX - minX, maxY - minY), 1.0f);
+        float scale = 65535.0f/rootSize;
+
+        keys.resize(count);
+        order.resize(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            keys[i] = MortonEncode((uint32_t)((circles.positions[i].x - minX)*scale), (uint32_t)((circles.positions[i].y - minY)*scale));
+            order[i] = (uint32_t)i;
+        }
+
+        RadixSortByKey(keys, order, keysScratch, orderScratch);
+
+        bodyX.resize(count);
+        bodyY.resize(count);
+        bodyMass.resize(count);
+
+        auto gather = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++)
+            {
+                uint32_t index = order[i];
+                bodyX[i] = circles.positions[index].x;
+                bodyY[i] = circles.positions[index].y;
+                bodyMass[i] = circles.radii[index]*circles.radii[index];
+            }
+        };
+
+        if (pool != nullptr) pool->ParallelFor("GravityGather", count, 4096, gather);
+        else gather(0, count);
+    }
+
+    void BuildTree(ThreadPool *pool)
+    {
+        nodes.clear();
+        subtreeCount = 0;
+
+        nodes.push_back({});
+        BuildNode(nodes, 0, 0, (uint32_t)keys.size(), 0, rootSize, true);
+
+        size_t topCount = nodes.size();
+
+        auto buildSubtrees = [&](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; t++)
+            {
+                Subtree &subtree = subtrees[t];
+                subtree.nodes.clear();
+                subtree.nodes.push_back({});
+                BuildNode(subtree.nodes, 0, subtree.begin, subtree.end, subtree.level, subtree.size, false);
+            }
+        };
+
+        if (pool != nullptr) pool->ParallelFor("GravitySubtrees", subtreeCount, 1, buildSubtrees);
+        else buildSubtrees(0, subtreeCount);
+
+        // Concatenate: a subtree root replaces its placeholder, the rest is appended and re-indexed
+        for (size_t t = 0; t < subtreeCount; t++)
+        {
+            const Subtree &subtree = subtrees[t];
+            uint32_t offset = (uint32_t)nodes.size() - 1;  // Subtree index k > 0 lands at offset + k
+
+            Node root = subtree.nodes[0];
+            if (root.childCount > 0) root.firstChild += offset;
+            nodes[subtree.node] = root;
+
+            for (size_t k = 1; k < subtree.nodes.size(); k++)
+            {
+                Node node = subtree.nodes[k];
+                if (node.childCount > 0) node.firstChild += offset;
+                nodes.push_back(node);
+            }
+        }
+
+        // Top level centers of mass, children always come after their parent
+        for (size_t n = topCount; n-- > 0;)
+        {
+            if (nodes[n].childCount > 0) SumChildren(nodes, (uint32_t)n);
+        }
+
+        leaves.clear();
+        for (uint32_t n = 0; n < (uint32_t)nodes.size(); n++)
+        {
+            if (nodes[n].childCount == 0) leaves.push_back(n);
+        }
+    }
+
+    // Build the cell holding sorted bodies [begin, end) into tree[index], children are appended
+    // At subtreeLevel the top level build stops and queues the cell as a parallel subtree
+    void BuildNode(std::vector<Node> &tree, uint32_t index, uint32_t begin, uint32_t end, int level, float size, bool topLevel)
+    {
+        tree[index] = { 0.0f, 0.0f, 0.0f, size, 0, 0, begin, end };
+
+        if ((end - begin <= (uint32_t)leafSize) || (level == maxLevel))
+        {
+            float mass = 0.0f, x = 0.0f, y = 0.0f;
+            for (uint32_t i = begin; i < end; i++)
+            {
+                mass += bodyMass[i];
+                x += bodyX[i]*bodyMass[i];
+                y += bodyY[i]*bodyMass[i];
+            }
+
+            tree[index].mass = mass;
+            tree[index].centerX = x/mass;
+            tree[index].centerY = y/mass;
+            return;
+        }
+
+        if (topLevel && (level == subtreeLevel))
+        {
+            if (subtreeCount == subtrees.size()) subtrees.emplace_back();
+            Subtree &subtree = subtrees[subtreeCount++];
+            subtree.node = index;
+            subtree.begin = begin;
+            subtree.end = end;
+            subtree.level = level;
+            subtree.size = size;
+            return;
+        }
+
+        // Bodies of a cell share the code bits above this level, the next two bits pick the quadrant
+        int shift = 30 - 2*level;
+        uint32_t bounds[5] = { begin, 0, 0, 0, end };
+        for (uint32_t quadrant = 1; quadrant < 4; quadrant++)
+        {
+            bounds[quadrant] = (uint32_t)(std::partition_point(keys.begin() + bounds[quadrant - 1], keys.begin() + end,
+                [&](uint32_t key) { return ((key >> shift) & 3) < quadrant; }) - keys.begin());
+        }
+
+        uint32_t childCount = 0;
+        for (int q = 0; q < 4; q++) childCount += (bounds[q + 1] > bounds[q])? 1 : 0;
+
+        uint32_t firstChild = (uint32_t)tree.size();
+        tree[index].firstChild = firstChild;
+        tree[index].childCount = childCount;
+        tree.resize(tree.size() + childCount);
+
+        uint32_t child = firstChild;
+        for (int q = 0; q < 4; q++)
+        {
+            if (bounds[q + 1] > bounds[q]) BuildNode(tree, child++, bounds[q], bounds[q + 1], level + 1, size*0.5f, topLevel);
+        }
+
+        // Subtree placeholders are filled later, the top level sums them after the merge
+        if (!topLevel) SumChildren(tree, index);
+    }
+
+    static void SumChildren(std::vector<Node> &tree, uint32_t index)
+    {
+        Node &node = tree[index];
+        float mass = 0.0f, x = 0.0f, y = 0.0f;
+
+        for (uint32_t c = node.firstChild; c < node.firstChild + node.childCount; c++)
+        {
+            mass += tree[c].mass;
+            x += tree[c].centerX*tree[c].mass;
+            y += tree[c].centerY*tree[c].mass;
+        }
+
+        node.mass = mass;
+        node.centerX = x/mass;
+        node.centerY = y/mass;
+    }
+
+    // Walk the tree once for a whole leaf, then sum the interaction list for each of its bodies
+    void EvaluateLeaf(uint32_t leafIndex, Vector2 *accelerations)
+    {
+        const Node &leaf = nodes[leafIndex];
+
+        float boxMinX = bodyX[leaf.begin], boxMaxX = boxMinX;
+        float boxMinY = bodyY[leaf.begin], boxMaxY = boxMinY;
+        for (uint32_t i = leaf.begin + 1; i < leaf.end; i++)
+        {
+            boxMinX = fminf(boxMinX, bodyX[i]); boxMaxX = fmaxf(boxMaxX, bodyX[i]);
+            boxMinY = fminf(boxMinY, bodyY[i]); boxMaxY = fmaxf(boxMaxY, bodyY[i]);
+        }
+
+        // Per thread interaction list, grown once and reused
+        static thread_local std::vector<float> sourceX, sourceY, sourceMass;
+        sourceX.clear();
+        sourceY.clear();
+        sourceMass.clear();
+
+        float theta2 = theta*theta;
+
+        uint32_t stack[4*maxLevel + 4];
+        int top = 0;
+        stack[top++] = 0;
+
+        while (top > 0)
+        {
+            const Node &node = nodes[stack[--top]];
+
+            // Distance from the center of mass to the closest point of the leaf box
+            float dx = fmaxf(fmaxf(boxMinX - node.centerX, node.centerX - boxMaxX), 0.0f);
+            float dy = fmaxf(fmaxf(boxMinY - node.centerY, node.centerY - boxMaxY), 0.0f);
+
+            // Ancestors of the leaf are always opened: with a large theta their center of mass can
+            // pass the test while their mass includes the leaf bodies, which are summed directly
+            bool ancestor = (node.begin <= leaf.begin) && (leaf.end <= node.end);
+
+            if (!ancestor && (node.size*node.size < theta2*(dx*dx + dy*dy)))
+            {
+                sourceX.push_back(node.centerX);
+                sourceY.push_back(node.centerY);
+                sourceMass.push_back(node.mass);
+            }
+            else if (node.childCount == 0)
+            {
+                // Includes the leaf itself, a body's own term vanishes (zero offset, softened distance)
+                for (uint32_t i = node.begin; i < node.end; i++)
+                {
+                    sourceX.push_back(bodyX[i]);
+                    sourceY.push_back(bodyY[i]);
+                    sourceMass.push_back(bodyMass[i]);
+                }
+            }
+            else
+            {
+                for (uint32_t c = 0; c < node.childCount; c++) stack[top++] = node.firstChild + c;
+            }
+        }
+
+        // Pad to whole Float4 groups with massless sources
+        while (sourceX.size() % 4 != 0)
+        {
+            sourceX.push_back(0.0f);
+            sourceY.push_back(0.0f);
+            sourceMass.push_back(0.0f);
+        }
+
+        Float4 softening2 = Float4::Set1(fmaxf(softening*softening, 1e-6f));
+        Float4 one = Float4::Set1(1.0f);
+
+        for (uint32_t i = leaf.begin; i < leaf.end; i++)
+        {
+            Float4 x = Float4::Set1(bodyX[i]);
+            Float4 y = Float4::Set1(bodyY[i]);
+            Float4 ax = Float4::Set1(0.0f);
+            Float4 ay = Float4::Set1(0.0f);
+
+            for (size_t s = 0; s < sourceX.size(); s += 4)
+            {
+                Float4 dx = Float4::LoadUnaligned(sourceX.data() + s) - x;
+                Float4 dy = Float4::LoadUnaligned(sourceY.data() + s) - y;
+                Float4 distance2 = dx*dx + dy*dy + softening2;
+                Float4 inverse = one/Sqrt(distance2);
+                Float4 strength = Float4::LoadUnaligned(sourceMass.data() + s)*inverse*inverse*inverse;
+
+                ax = ax + dx*strength;
+                ay = ay + dy*strength;
+            }
+
+            Vector2 &acceleration = accelerations[order[i]];
+            acceleration.x += gravitationalConstant*ax.Sum();
+            acceleration.y += gravitationalConstant*ay.Sum();
+        }
+    }
+
+    float rootSize = 1.0f;
+
+    // Bodies in Morton order
+    std::vector<uint32_t> keys;
+    std::vector<uint32_t> order;        // Sorted position -> dense circle index
+    std::vector<uint32_t> keysScratch;
+    std::vector<uint32_t> orderScratch;
+    std::vector<float> bodyX;
+    std::vector<float> bodyY;
+    std::vector<float> bodyMass;
+
+    std::vector<Node> nodes;            // Root first, children after their parent
+    std::vector<uint32_t> leaves;
+    std::vector<Subtree> subtrees;
+    size_t subtreeCount = 0;
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "raylib.h"
+
+#include "circle_pool.h"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Pair of dense circle indices whose bounds overlap, always a < b
+struct CirclePair
+{
+    uint32_t a;
+    uint32_t b;
+};
+
+// Broadphase interface, implementations are selectable at runtime (CircleSimulation::broadphase)
+class Broadphase
+{
+public:
+    virtual ~Broadphase() = default;
+
+    virtual const char *Name() const = 0;
+
+    // Bring the structure up to date with the current circle positions, radii and dense order
+    virtual void Update(const CirclePool &circles, float width, float height) = 0;
+
+    // Replace pairs with every pair whose bounding boxes overlap, exact circle tests are left to the solver
+    virtual void FindPairs(const CirclePool &circles, std::vector<CirclePair> &pairs) = 0;
+
+protected:
+    static void TestPair(const CirclePool &circles, uint32_t a, uint32_t b, std::vector<CirclePair> &pairs)
+    {
+        float reach = circles.radii[a] + circles.radii[b];
+        Vector2 pa = circles.positions[a];
+        Vector2 pb = circles.positions[b];
+
+        if ((fabsf(pa.x - pb.x) < reach) && (fabsf(pa.y - pb.y) < reach))
+        {
+            pairs.push_back((a < b)? CirclePair{ a, b } : CirclePair{ b, a });
+        }
+    }
+};
@@ -0,0 +1,287 @@
+#include "raylib.h"
+#include "raymath.h"
+
+#include "aabb_tree.h"
+#include "circle_simulation.h"
+#include "raymath_constexpr.h"
+#include "uniform_grid.h"
+
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+// Broadphase benchmark: uniform grid vs dynamic AABB tree across circle radius distributions
+// Usage: broadphase_benchmark.exe [circles] [steps]
+// Before benchmarking, the cx:: constexpr math is checked against raymath (exit code 1 on mismatch)
+
+enum RadiusDistribution {
+    RADIUS_CONSTANT = 0,                // Every circle the same size
+    RADIUS_UNIFORM,                     // 5 to 20, the windowed example spawn range
+    RADIUS_LOG_UNIFORM,                 // 2 to 80, log-uniform
+    RADIUS_BIMODAL,                     // Mostly 3, a few 60
+    RADIUS_GIANTS,                      // Mostly 2, very few 150
+    RADIUS_DISTRIBUTION_COUNT
+};
+
+static const char *distributionNames[RADIUS_DISTRIBUTION_COUNT] = { "constant 8", "uniform 5-20", "log-uniform 2-80", "bimodal 3/60", "giants 2/150" };
+
+static float RandomRadius(RadiusDistribution distribution, std::mt19937 &rng)
+{
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    switch (distribution)
+    {
+        case RADIUS_CONSTANT: return 8.0f;
+        case RADIUS_UNIFORM: return 5.0f + 15.0f*unit(rng);
+        case RADIUS_LOG_UNIFORM: return 2.0f*powf(40.0f, unit(rng));
+        case RADIUS_BIMODAL: return (unit(rng) < 0.97f)? 3.0f : 60.0f;
+        case RADIUS_GIANTS: return (unit(rng) < 0.998f)? 2.0f : 150.0f;
+        default: return 8.0f;
+    }
+}
+
+// Spawn circles covering ~30% of a world sized for them, returns the world size
+static Vector2 SpawnCircles(CirclePool &circles, int count, RadiusDistribution distribution)
+{
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    std::vector<float> radii(count);
+    float area = 0.0f;
+    for (int i = 0; i < count; i++)
+    {
+        radii[i] = RandomRadius(distribution, rng);
+        area += PI*radii[i]*radii[i];
+    }
+
+    float height = sqrtf(area/0.3f*9.0f/16.0f);
+    Vector2 world = { height*16.0f/9.0f, height };
+
+    for (int i = 0; i < count; i++)
+    {
+        float angle = 2.0f*PI*unit(rng);
+        float speed = 50.0f + 200.0f*unit(rng);
+        Vector2 position = { radii[i] + (world.x - 2.0f*radii[i])*unit(rng), radii[i] + (world.y - 2.0f*radii[i])*unit(rng) };
+
+        circles.Spawn(position, { cosf(angle)*speed, sinf(angle)*speed }, radii[i], WHITE);
+    }
+
+    return world;
+}
+
+//----------------------------------------------------------------------------------
+// cx:: (raymath_constexpr.h) vs raymath.h
+//----------------------------------------------------------------------------------
+// The static_asserts in raymath_constexpr.h pin a few literals, only comparing against raymath
+// itself catches a cx:: formula drifting from its raymath counterpart
+constexpr int mathSweepCount = 256;
+
+// Sweep input i of mathSweepCount in [min, max]
+constexpr float SweepValue(int i, float min, float max) { return min + (max - min)*(float)i/(float)(mathSweepCount - 1); }
+
+// Distance in representable floats, both signs mapped onto one ordered integer line
+static int64_t UlpDistance(float a, float b)
+{
+    int32_t ia = std::bit_cast<int32_t>(a);
+    int32_t ib = std::bit_cast<int32_t>(b);
+    int64_t oa = (ia < 0)? (int64_t)INT32_MIN - ia : ia;
+    int64_t ob = (ib < 0)? (int64_t)INT32_MIN - ib : ib;
+
+    return (oa > ob)? oa - ob : ob - oa;
+}
+
+struct MathCheck
+{
+    const char *name;
+    int64_t maxUlps;                    // Tolerance
+    float absolute;                     // Also accepted, ulps are meaningless for results near zero
+    int64_t worstUlps = 0;
+    int failures = 0;
+
+    void Compare(const float *cx, const float *reference, int count)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            int64_t ulps = UlpDistance(cx[i], reference[i]);
+            if (ulps > worstUlps) worstUlps = ulps;
+            if ((ulps > maxUlps) && (fabsf(cx[i] - reference[i]) > absolute)) failures++;
+        }
+    }
+
+    template <typename T>
+    void Compare(const T &cx, const T &reference)
+    {
+        static_assert((sizeof(T)%sizeof(float)) == 0);
+
+        float a[sizeof(T)/sizeof(float)];
+        float b[sizeof(T)/sizeof(float)];
+        memcpy(a, &cx, sizeof(T));
+        memcpy(b, &reference, sizeof(T));
+        Compare(a, b, (int)(sizeof(T)/sizeof(float)));
+    }
+};
+
+// Constant evaluated sweeps, the compile-time path of cx::Sqrt/Sin/Cos (double, rounded to float)
+template <typename Function>
+constexpr std::array<float, mathSweepCount> ConstexprSweep(Function function, float min, float max)
+{
+    std::array<float, mathSweepCount> values = {};
+    for (int i = 0; i < mathSweepCount; i++) values[i] = function(SweepValue(i, min, max));
+    return values;
+}
+
+constexpr std::array<float, mathSweepCount> constexprSqrt = ConstexprSweep([](float x) { return cx::Sqrt(x); }, 0.0f, 1000.0f);
+constexpr std::array<float, mathSweepCount> constexprSin = ConstexprSweep([](float x) { return cx::Sin(x); }, -100.0f, 100.0f);
+constexpr std::array<float, mathSweepCount> constexprCos = ConstexprSweep([](float x) { return cx::Cos(x); }, -100.0f, 100.0f);
+
+static int ReportMathCheck(const MathCheck &check)
+{
+    if (check.failures > 0) printf("MATH: %s differs from raymath in %i results (worst %lli ulps)\n", check.name, check.failures, (long long)check.worstUlps);
+    return check.failures;
+}
+
+// Returns the number of mismatching results
+static int CheckConstexprMath(void)
+{
+    MathCheck scalar[] = { { "Sqrt (constexpr)", 1, 0.0f }, { "Sin (constexpr)", 1, 1e-7f }, { "Cos (constexpr)", 1, 1e-7f } };
+    const std::array<float, mathSweepCount> *tables[] = { &constexprSqrt, &constexprSin, &constexprCos };
+
+    for (int i = 0; i < mathSweepCount; i++)
+    {
+        float root = sqrtf(SweepValue(i, 0.0f, 1000.0f));
+        float sine = sinf(SweepValue(i, -100.0f, 100.0f));
+        float cosine = cosf(SweepValue(i, -100.0f, 100.0f));
+
+        scalar[0].Compare(&(*tables[0])[i], &root, 1);
+        scalar[1].Compare(&(*tables[1])[i], &sine, 1);
+        scalar[2].Compare(&(*tables[2])[i], &cosine, 1);
+    }
+
+    // Runtime path: same formulas as raymath on the same libm calls, results must match
+    MathCheck functions[] = {
+        { "Vector2Length", 1, 0.0f }, { "Vector2Normalize", 1, 0.0f }, { "Vector2Rotate", 1, 1e-6f },
+        { "Vector2Transform", 1, 1e-6f }, { "Vector2Lerp", 1, 1e-6f }, { "Vector3CrossProduct", 1, 1e-6f },
+        { "Vector3Normalize", 1, 0.0f }, { "Vector3Transform", 1, 1e-6f }, { "Vector3RotateByQuaternion", 1, 1e-6f },
+        { "MatrixMultiply", 1, 1e-6f }, { "MatrixRotateZ", 1, 1e-7f }, { "MatrixRotate", 1, 1e-7f },
+        { "MatrixOrtho", 1, 0.0f }, { "QuaternionNormalize", 1, 0.0f }, { "QuaternionMultiply", 1, 1e-6f },
+        { "QuaternionFromAxisAngle", 1, 1e-7f }, { "QuaternionToMatrix", 1, 1e-7f }
+    };
+
+    for (int i = 0; i < mathSweepCount; i++)
+    {
+        float angle = SweepValue(i, -2.0f*PI, 2.0f*PI);
+        float t = SweepValue(i, -1.0f, 2.0f);
+        Vector2 v2 = { SweepValue(i, -300.0f, 500.0f), SweepValue(mathSweepCount - 1 - i, -50.0f, 800.0f) };
+        Vector2 w2 = { t*7.0f - 3.0f, 11.0f - t*5.0f };
+        Vector3 v3 = { v2.x, v2.y, SweepValue(i, 5.0f, -9.0f) };
+        Vector3 axis = { 0.3f + t, -0.7f, 1.1f - t };
+        Quaternion q = { axis.x, axis.y, axis.z, SweepValue(i, -1.5f, 1.5f) };
+        Quaternion r = { -0.2f, t, 0.5f, 0.8f };
+        Matrix rotation = ::MatrixRotate(axis, angle);
+        Matrix ortho = ::MatrixOrtho(0.0, 100.0 + i, 50.0 + i, 0.0, -1.0, 1.0 + t);
+
+        float cxLength = cx::Vector2Length(v2);
+        float length = ::Vector2Length(v2);
+        functions[0].Compare(&cxLength, &length, 1);
+        functions[1].Compare(cx::Vector2Normalize(v2), ::Vector2Normalize(v2));
+        functions[2].Compare(cx::Vector2Rotate(v2, angle), ::Vector2Rotate(v2, angle));
+        functions[3].Compare(cx::Vector2Transform(v2, rotation), ::Vector2Transform(v2, rotation));
+        functions[4].Compare(cx::Vector2Lerp(v2, w2, t), ::Vector2Lerp(v2, w2, t));
+        functions[5].Compare(cx::Vector3CrossProduct(v3, axis), ::Vector3CrossProduct(v3, axis));
+        functions[6].Compare(cx::Vector3Normalize(v3), ::Vector3Normalize(v3));
+        functions[7].Compare(cx::Vector3Transform(v3, rotation), ::Vector3Transform(v3, rotation));
+        functions[8].Compare(cx::Vector3RotateByQuaternion(v3, ::QuaternionNormalize(q)), ::Vector3RotateByQuaternion(v3, ::QuaternionNormalize(q)));
+        functions[9].Compare(cx::MatrixMultiply(rotation, ortho), ::MatrixMultiply(rotation, ortho));
+        functions[10].Compare(cx::MatrixRotateZ(angle), ::MatrixRotateZ(angle));
+        functions[11].Compare(cx::MatrixRotate(axis, angle), rotation);
+        functions[12].Compare(cx::MatrixOrtho(0.0, 100.0 + i, 50.0 + i, 0.0, -1.0, 1.0 + t), ortho);
+        functions[13].Compare(cx::QuaternionNormalize(q), ::QuaternionNormalize(q));
+        functions[14].Compare(cx::QuaternionMultiply(q, r), ::QuaternionMultiply(q, r));
+        functions[15].Compare(cx::QuaternionFromAxisAngle(axis, angle), ::QuaternionFromAxisAngle(axis, angle));
+        functions[16].Compare(cx::QuaternionToMatrix(::QuaternionNormalize(q)), ::QuaternionToMatrix(::QuaternionNormalize(q)));
+    }
+
+    int failures = 0;
+    for (const MathCheck &check : scalar) failures += ReportMathCheck(check);
+    for (const MathCheck &check : functions) failures += ReportMathCheck(check);
+
+    if (failures == 0) printf("cx:: constexpr math matches raymath (%i sweep inputs per function)\n\n", mathSweepCount);
+    return failures;
+}
+
+struct BenchmarkResult
+{
+    double updateMs;                    // Average Update() time per step
+    double pairsMs;                     // Average FindPairs() time per step
+    size_t pairs;                       // Candidate pairs on the last step
+};
+
+static BenchmarkResult RunBenchmark(Broadphase &broadphase, int circleCount, int steps, RadiusDistribution distribution)
+{
+    CirclePool circles(circleCount);
+    Vector2 world = SpawnCircles(circles, circleCount, distribution);
+
+    SpatialSorter sorter;
+    std::vector<CirclePair> pairs;
+    double updateTime = 0.0;
+    double pairsTime = 0.0;
+
+    for (int step = 0; step < steps; step++)
+    {
+        UpdateCircles(circles, 1.0f/60.0f, world.x, world.y);
+        if ((step % 30) == 0) sorter.Sort(circles);
+
+        auto start = std::chrono::steady_clock::now();
+        broadphase.Update(circles, world.x, world.y);
+        auto updated = std::chrono::steady_clock::now();
+        broadphase.FindPairs(circles, pairs);
+        auto end = std::chrono::steady_clock::now();
+
+        // The first step builds from scratch, leave it out of the steady-state average
+        if (step > 0)
+        {
+            updateTime += std::chrono::duration<double, std::milli>(updated - start).count();
+            pairsTime += std::chrono::duration<double, std::milli>(end - updated).count();
+        }
+    }
+
+    int measured = (steps > 1)? steps - 1 : 1;
+    return { updateTime/measured, pairsTime/measured, pairs.size() };
+}
+
+int main(int argc, char *argv[])
+{
+    int circleCount = (argc > 1)? atoi(argv[1]) : 20000;
+    int steps = (argc > 2)? atoi(argv[2]) : 120;
+
+    if (CheckConstexprMath() > 0) return 1;
+
+    printf("Broadphase benchmark: %i circles, %i steps, ~30%% coverage\n\n", circleCount, steps);
+    printf("%-18s | %-12s | %10s | %10s | %10s | %8s\n", "radii", "broadphase", "update ms", "pairs ms", "total ms", "pairs");
+    printf("-------------------+--------------+------------+------------+------------+---------\n");
+
+    for (int d = 0; d < RADIUS_DISTRIBUTION_COUNT; d++)
+    {
+        RadiusDistribution distribution = (RadiusDistribution)d;
+
+        UniformGrid grid;
+        AabbTree tree;
+        Broadphase *broadphases[] = { &grid, &tree };
+
+        for (Broadphase *broadphase : broadphases)
+        {
+            BenchmarkResult result = RunBenchmark(*broadphase, circleCount, steps, distribution);
+
+            printf("%-18s | %-12s | %10.3f | %10.3f | %10.3f | %8zu\n", distributionNames[d], broadphase->Name(),
+                result.updateMs, result.pairsMs, result.updateMs + result.pairsMs, result.pairs);
+        }
+    }
+
+    return 0;
+}
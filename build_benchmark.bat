@@ -0,0 +1,3 @@
+g++ .\broadphase_benchmark.cpp -o broadphase_benchmark.exe -I libs/raylib/include -L libs/raylib/lib -lraylib -lopengl32 -lgdi32 -lwinmm -std=c++20 -O2 %*
+
+broadphase_benchmark.exe
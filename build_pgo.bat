@@ -0,0 +1,19 @@
+@echo off
+rem Profile-guided optimization build
+rem   1. Instrumented build writing profile data into pgo/
+rem   2. Training run on the headless circle simulation (representative workload)
+rem   3. Optimized rebuild using the collected profile
+rem Extra arguments are forwarded to g++ on both builds, e.g. build_pgo.bat -march=native
+
+set FLAGS=-I libs/raylib/include -L libs/raylib/lib -lraylib -lopengl32 -lgdi32 -lwinmm -std=c++20 -O2 %*
+
+if exist pgo rmdir /s /q pgo
+
+g++ .\getting_started_with_raylib.cpp -o getting_started_with_raylib.exe %FLAGS% -fprofile-generate=pgo -fprofile-update=atomic || exit /b 1
+
+getting_started_with_raylib.exe --headless 20000 600 || exit /b 1
+getting_started_with_raylib.exe --headless 2000 3000 || exit /b 1
+
+g++ .\getting_started_with_raylib.cpp -o getting_started_with_raylib.exe %FLAGS% -fprofile-use=pgo -fprofile-correction -Wno-missing-profile || exit /b 1
+
+getting_started_with_raylib.exe --headless 20000 600
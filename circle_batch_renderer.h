@@ -0,0 +1,154 @@
+#pragma once
+
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+
+#include "circle_pool.h"
+#include "circle_tessellation.h"
+#include "thread_pool.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Bulk circle submission: every circle of a pool in one vertex upload and one draw call
+// rlVertex2f() pays the batch limit check, the transform test and four array writes per vertex
+// and the default batch flushes every 8192 quads; here vertex space for the whole pool is
+// reserved once, the triangles are written straight into a vertex array (in parallel when a
+// ThreadPool is given) and drawn with the default shader from a dedicated VAO/VBO
+// NOTE: Owns GPU memory, call Unload() before CloseWindow()
+class CircleBatchRenderer
+{
+public:
+    void Load(int vertexCapacity = 1 << 16)
+    {
+        vaoId = rlLoadVertexArray();
+        CreateVertexBuffer((size_t)vertexCapacity);
+    }
+
+    void Unload()
+    {
+        if (vboId > 0) rlUnloadVertexBuffer(vboId);
+        if (vaoId > 0) rlUnloadVertexArray(vaoId);
+
+        vboId = 0;
+        vaoId = 0;
+        gpuCapacity = 0;
+    }
+
+    // Draw the circles with the current rlgl transform, on top of anything drawn before
+    void Draw(const CirclePool &circles, ThreadPool *pool = nullptr)
+    {
+        Draw(circles.positions.data(), circles.radii.data(), circles.colors.data(), circles.Size(), pool);
+    }
+
+    // Same from plain arrays (e.g. a simulation snapshot)
+    void Draw(const Vector2 *positions, const float *radii, const Color *colors, size_t count, ThreadPool *pool = nullptr)
+    {
+        if (count == 0) return;
+
+        // Reserve: first vertex of every circle
+        firstVertex.resize(count + 1);
+        firstVertex[0] = 0;
+        for (size_t i = 0; i < count; i++) firstVertex[i + 1] = firstVertex[i] + 3*UnitCircleForRadius(radii[i]).segments;
+
+        size_t vertexCount = firstVertex[count];
+        vertices.resize(vertexCount);
+
+        auto write = [&](size_t begin, size_t end) { WriteCircles(positions, radii, colors, begin, end); };
+
+        if (pool != nullptr) pool->ParallelFor("BuildCircleVertices", count, 512, write);
+        else write(0, count);
+
+        // Shapes already in the rlgl batch must land below the circles
+        rlDrawRenderBatchActive();
+
+        if (vertexCount > gpuCapacity) CreateVertexBuffer(vertexCount + vertexCount/2);
+        rlUpdateVertexBuffer(vboId, vertices.data(), (int)(vertexCount*sizeof(CircleVertex)), 0);
+
+        int *locs = rlGetShaderLocsDefault();
+        Matrix mvp = MatrixMultiply(MatrixMultiply(rlGetMatrixTransform(), rlGetMatrixModelview()), rlGetMatrixProjection());
+        const float white[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+        rlEnableShader(rlGetShaderIdDefault());
+        rlSetUniformMatrix(locs[RL_SHADER_LOC_MATRIX_MVP], mvp);
+        rlSetUniform(locs[RL_SHADER_LOC_COLOR_DIFFUSE], white, RL_SHADER_UNIFORM_VEC4, 1);
+
+        // The default shader samples texture0, texcoords stay at the (0, 0) attribute default
+        rlActiveTextureSlot(0);
+        rlEnableTexture(rlGetTextureIdDefault());
+
+        if (!rlEnableVertexArray(vaoId))
+        {
+            // No VAO support (OpenGL ES 2.0 without extension), bind the attributes every draw
+            rlEnableVertexBuffer(vboId);
+            SetVertexAttributes();
+        }
+
+        rlDrawVertexArray(0, (int)vertexCount);
+
+        rlDisableVertexArray();
+        rlDisableVertexBuffer();
+        rlDisableTexture();
+        rlDisableShader();
+    }
+
+private:
+    struct CircleVertex
+    {
+        float x, y;
+        Color color;
+    };
+
+    void WriteCircles(const Vector2 *positions, const float *radii, const Color *colors, size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            const UnitCircleTable &table = UnitCircleForRadius(radii[i]);
+            const Vector2 *points = table.points;
+
+            Vector2 center = positions[i];
+            float radius = radii[i];
+            Color color = colors[i];
+            CircleVertex *out = &vertices[firstVertex[i]];
+
+            // Same triangles and winding as EmitCircleTriangles()
+            for (int s = 0; s < table.segments; s++)
+            {
+                out[0] = { center.x, center.y, color };
+                out[1] = { center.x + points[s + 1].x*radius, center.y + points[s + 1].y*radius, color };
+                out[2] = { center.x + points[s].x*radius, center.y + points[s].y*radius, color };
+                out += 3;
+            }
+        }
+    }
+
+    void CreateVertexBuffer(size_t capacity)
+    {
+        if (vboId > 0) rlUnloadVertexBuffer(vboId);
+
+        rlEnableVertexArray(vaoId);
+        vboId = rlLoadVertexBuffer(nullptr, (int)(capacity*sizeof(CircleVertex)), true);
+        SetVertexAttributes();
+        rlDisableVertexArray();
+
+        gpuCapacity = capacity;
+    }
+
+    // Position (vec2, z defaults to 0) and normalized color, interleaved
+    static void SetVertexAttributes()
+    {
+        rlSetVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION, 2, RL_FLOAT, false, sizeof(CircleVertex), 0);
+        rlEnableVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION);
+        rlSetVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR, 4, RL_UNSIGNED_BYTE, true, sizeof(CircleVertex), offsetof(CircleVertex, color));
+        rlEnableVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR);
+    }
+
+    unsigned int vaoId = 0;
+    unsigned int vboId = 0;
+    size_t gpuCapacity = 0;             // Vertices the GPU buffer can hold
+
+    std::vector<CircleVertex> vertices; // Kept between frames, only grows
+    std::vector<uint32_t> firstVertex;
+};
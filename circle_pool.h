@@ -0,0 +1,183 @@
+#pragma once
+
+#include "raylib.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Stable reference to a circle living in a CirclePool
+// NOTE: Handles survive spawns, despawns and array growth; a handle whose circle was
+// despawned is detected through its generation and never aliases a newer circle
+struct CircleHandle
+{
+    uint32_t index = UINT32_MAX;        // Slot in the pool sparse table
+    uint32_t generation = 0;            // Slot generation when the handle was issued (0 is never valid)
+};
+
+// Circle storage with O(1) spawn/despawn and contiguous iteration
+// Circle data is kept as dense structure-of-arrays in [0, Size()), despawn moves the last
+// circle into the hole (swap-remove) so the arrays never have gaps
+class CirclePool
+{
+public:
+    explicit CirclePool(size_t capacity = 0)
+    {
+        Reserve(capacity);
+    }
+
+    // Preallocate storage so spawning up to capacity circles never reallocates
+    void Reserve(size_t capacity)
+    {
+        positions.reserve(capacity);
+        velocities.reserve(capacity);
+        accelerations.reserve(capacity);
+        radii.reserve(capacity);
+        colors.reserve(capacity);
+        denseToSlot.reserve(capacity);
+        slots.reserve(capacity);
+    }
+
+    CircleHandle Spawn(Vector2 position, Vector2 velocity, float radius, Color color)
+    {
+        uint32_t slotIndex = freeHead;
+
+        if (slotIndex == UINT32_MAX)
+        {
+            slotIndex = (uint32_t)slots.size();
+            slots.push_back({ 0, 1 });
+        }
+        else freeHead = slots[slotIndex].dense;     // Free slots chain through their dense field
+
+        Slot &slot = slots[slotIndex];
+        slot.dense = (uint32_t)positions.size();
+
+        positions.push_back(position);
+        velocities.push_back(velocity);
+        accelerations.push_back({ 0.0f, 0.0f });
+        radii.push_back(radius);
+        colors.push_back(color);
+        denseToSlot.push_back(slotIndex);
+
+        return { slotIndex, slot.generation };
+    }
+
+    // Remove a circle, returns false if the handle is stale
+    bool Despawn(CircleHandle handle)
+    {
+        if (!IsAlive(handle)) return false;
+
+        Slot &slot = slots[handle.index];
+        RemoveDense(slot.dense);
+
+        slot.generation++;
+        if (slot.generation == 0) slot.generation = 1;      // Skip the invalid generation on wrap
+        slot.dense = freeHead;
+        freeHead = handle.index;
+
+        return true;
+    }
+
+    // Remove the circle stored at a dense index (used when iterating, e.g. lifetime expiry)
+    // NOTE: The last circle is moved into denseIndex, so iterate backwards when despawning in a loop
+    void DespawnAt(size_t denseIndex)
+    {
+        Despawn({ denseToSlot[denseIndex], slots[denseToSlot[denseIndex]].generation });
+    }
+
+    bool IsAlive(CircleHandle handle) const
+    {
+        return (handle.index < slots.size()) && (slots[handle.index].generation == handle.generation);
+    }
+
+    // Dense index of a live circle, valid until the next despawn
+    size_t IndexOf(CircleHandle handle) const
+    {
+        return slots[handle.index].dense;
+    }
+
+    CircleHandle HandleAt(size_t denseIndex) const
+    {
+        uint32_t slotIndex = denseToSlot[denseIndex];
+        return { slotIndex, slots[slotIndex].generation };
+    }
+
+    size_t Size() const { return positions.size(); }
+    bool Empty() const { return positions.empty(); }
+
+    // Reorder the dense arrays so that dense index i holds the circle previously at order[i]
+    // Handles stay valid, dense indices change; order must be a permutation of [0, Size())
+    void Reorder(const std::vector<uint32_t> &order)
+    {
+        Permute(positions, scratchVectors, order);
+        Permute(velocities, scratchVectors, order);
+        Permute(accelerations, scratchVectors, order);
+        Permute(radii, scratchFloats, order);
+        Permute(colors, scratchColors, order);
+        Permute(denseToSlot, scratchIndices, order);
+
+        for (size_t i = 0; i < denseToSlot.size(); i++) slots[denseToSlot[i]].dense = (uint32_t)i;
+    }
+
+    // Despawn every circle, all outstanding handles become stale
+    void Clear()
+    {
+        while (!positions.empty()) DespawnAt(positions.size() - 1);
+    }
+
+    // Dense circle data, indexed [0, Size())
+    std::vector<Vector2> positions;
+    std::vector<Vector2> velocities;
+    std::vector<Vector2> accelerations;
+    std::vector<float> radii;
+    std::vector<Color> colors;
+
+private:
+    struct Slot
+    {
+        uint32_t dense;                 // Dense index while alive, next free slot while free
+        uint32_t generation;
+    };
+
+    void RemoveDense(uint32_t denseIndex)
+    {
+        size_t last = positions.size() - 1;
+
+        if (denseIndex != last)
+        {
+            positions[denseIndex] = positions[last];
+            velocities[denseIndex] = velocities[last];
+            accelerations[denseIndex] = accelerations[last];
+            radii[denseIndex] = radii[last];
+            colors[denseIndex] = colors[last];
+            denseToSlot[denseIndex] = denseToSlot[last];
+            slots[denseToSlot[denseIndex]].dense = denseIndex;
+        }
+
+        positions.pop_back();
+        velocities.pop_back();
+        accelerations.pop_back();
+        radii.pop_back();
+        colors.pop_back();
+        denseToSlot.pop_back();
+    }
+
+    template <typename T>
+    static void Permute(std::vector<T> &values, std::vector<T> &scratch, const std::vector<uint32_t> &order)
+    {
+        scratch.reserve(values.capacity());     // Swapping must not shrink the reserved capacity
+        scratch.resize(values.size());
+        for (size_t i = 0; i < order.size(); i++) scratch[i] = values[order[i]];
+        values.swap(scratch);
+    }
+
+    std::vector<uint32_t> denseToSlot;  // Owning slot of each dense circle
+    std::vector<Slot> slots;            // Sparse handle table
+    uint32_t freeHead = UINT32_MAX;     // First free slot, UINT32_MAX when none
+
+    // Reorder() buffers, kept so periodic reordering does not allocate
+    std::vector<Vector2> scratchVectors;
+    std::vector<float> scratchFloats;
+    std::vector<Color> scratchColors;
+    std::vector<uint32_t> scratchIndices;
+};
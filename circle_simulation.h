@@ -0,0 +1,205 @@
+#pragma once
+
+#include "raylib.h"
+#include "raymath.h"
+
+#include "aabb_tree.h"
+#include "barnes_hut.h"
+#include "broadphase.h"
+#include "circle_pool.h"
+#include "contact_solver.h"
+#include "cpu_compute.h"
+#include "fast_math.h"
+#include "force_field.h"
+#include "spatial_sort.h"
+#include "thread_pool.h"
+#include "trace.h"
+#include "uniform_grid.h"
+
+#include <chrono>
+#include <vector>
+
+// Circles plus the simulation working state, kept between steps so steady-state steps do not allocate
+struct CircleSimulation
+{
+    CircleSimulation(float width, float height, size_t capacity) : circles(capacity), width(width), height(height)
+    {
+        pairs.reserve(capacity*4);
+    }
+
+    CircleSimulation(const CircleSimulation &) = delete;
+    CircleSimulation &operator=(const CircleSimulation &) = delete;
+
+    CirclePool circles;
+    UniformGrid grid;
+    AabbTree tree;
+    Broadphase *broadphase = &grid;     // Either grid or tree, switchable between steps
+    ContactSolver solver;
+    std::vector<CirclePair> pairs;      // Broadphase output, reused every step
+    ThreadPool *pool = nullptr;         // Workers for the parallel stages, single-threaded when null
+    SpatialSorter sorter;
+    int sortInterval = 30;              // Steps between Morton reorders, 0 disables them
+    int stepCounter = 0;
+    ForceFields forces;                 // Sets the circle accelerations, none by default
+    BarnesHutGravity gravity;
+    bool mutualGravity = false;         // Every circle attracts every other one (Barnes-Hut)
+    bool forcesApplied = false;         // Accelerations hold forces from an earlier step
+
+    float width;
+    float height;
+    bool collisions = true;             // Circle-vs-circle response, walls always collide
+};
+
+// Spawn a circle at position going in a random direction
+inline CircleHandle SpawnRandomCircle(CirclePool &circles, Vector2 position)
+{
+    float angle = (float)GetRandomValue(0, 359)*DEG2RAD;
+    float speed = (float)GetRandomValue(50, 250);
+#if defined(SIMULATION_FAST_MATH)
+    Vector2 velocity = FastVector2Rotate({ speed, 0.0f }, angle);
+#else
+    Vector2 velocity = { cosf(angle)*speed, sinf(angle)*speed };
+#endif
+    float radius = (float)GetRandomValue(5, 20);
+    Color color = ColorFromHSV((float)GetRandomValue(0, 359), 0.7f, 0.9f);
+
+    return circles.Spawn(position, velocity, radius, color);
+}
+
+// Storage binding points of the circle compute kernels
+enum CircleBinding {
+    CIRCLE_BINDING_POSITIONS = 0,
+    CIRCLE_BINDING_VELOCITIES,
+    CIRCLE_BINDING_ACCELERATIONS,
+    CIRCLE_BINDING_RADII
+};
+
+// Move circles by their velocity and acceleration and bounce them off the screen borders
+// One compute invocation per circle, work groups run on the pool workers when a pool is given
+inline void UpdateCircles(CirclePool &circles, float dt, float width, float height, ThreadPool *pool = nullptr)
+{
+    size_t count = circles.Size();
+
+    ComputeDispatcher compute(pool);
+    compute.BindStorage(CIRCLE_BINDING_POSITIONS, circles.positions);
+    compute.BindStorage(CIRCLE_BINDING_VELOCITIES, circles.velocities);
+    compute.BindStorage(CIRCLE_BINDING_ACCELERATIONS, circles.accelerations);
+    compute.BindStorage(CIRCLE_BINDING_RADII, circles.radii);
+
+    ComputeKernel integrate { "IntegrateCircles", { 256, 1, 1 }, [=](const ComputeInvocation &id, const ComputeBindings &buffers) {
+        size_t i = id.globalId.x;
+        if (i >= count) return;
+
+        Vector2 &position = buffers[CIRCLE_BINDING_POSITIONS].As<Vector2>()[i];
+        Vector2 &velocity = buffers[CIRCLE_BINDING_VELOCITIES].As<Vector2>()[i];
+        Vector2 acceleration = buffers[CIRCLE_BINDING_ACCELERATIONS].As<Vector2>()[i];
+        float radius = buffers[CIRCLE_BINDING_RADII].As<float>()[i];
+
+        velocity = Vector2Add(velocity, Vector2Scale(acceleration, dt));
+        position = Vector2Add(position, Vector2Scale(velocity, dt));
+
+        if ((position.x - radius) < 0.0f) { position.x = radius; velocity.x = -velocity.x; }
+        else if ((position.x + radius) > width) { position.x = width - radius; velocity.x = -velocity.x; }
+
+        if ((position.y - radius) < 0.0f) { position.y = radius; velocity.y = -velocity.y; }
+        else if ((position.y + radius) > height) { position.y = height - radius; velocity.y = -velocity.y; }
+    } };
+
+    compute.Dispatch(integrate, ComputeDispatcher::GroupCount(count, integrate.localSize.x));
+}
+
+// Recompute the circle accelerations from the force sources
+inline void ApplyForces(CircleSimulation &sim)
+{
+    // Without sources accelerations stay zero, they are only cleared once after the last source goes
+    bool sources = !sim.forces.Empty() || sim.mutualGravity;
+    if (!sources && !sim.forcesApplied) return;
+
+    sim.forces.Apply(sim.circles, sim.width, sim.height, sim.pool);      // Overwrites, zero without fields
+    if (sim.mutualGravity) sim.gravity.Accumulate(sim.circles, sim.pool);
+
+    sim.forcesApplied = sources;
+}
+
+// Advance the whole simulation by one step, shared by the windowed and headless loops
+inline void StepSimulation(CircleSimulation &sim, float dt)
+{
+    {
+        TRACE_SCOPE("Forces");
+        ApplyForces(sim);
+    }
+
+    {
+        TRACE_SCOPE("Integrate");
+        UpdateCircles(sim.circles, dt, sim.width, sim.height, sim.pool);
+    }
+
+    if (!sim.collisions) return;
+
+    if ((sim.sortInterval > 0) && ((sim.stepCounter++ % sim.sortInterval) == 0))
+    {
+        TRACE_SCOPE("SpatialSort");
+        sim.sorter.Sort(sim.circles);
+    }
+
+    {
+        TRACE_SCOPE("Broadphase");
+        sim.broadphase->Update(sim.circles, sim.width, sim.height);
+        sim.broadphase->FindPairs(sim.circles, sim.pairs);
+    }
+
+    {
+        TRACE_SCOPE("Collision");
+        sim.solver.Solve(sim.circles, sim.pairs, sim.pool);
+    }
+}
+
+// Grow the world with the circle count so density stays close to the windowed scenes (~30% covered)
+inline Vector2 HeadlessWorldSize(int circleCount, float width, float height)
+{
+    float averageArea = PI*12.5f*12.5f;
+    float scale = sqrtf(fmaxf(1.0f, circleCount*averageArea/(0.3f*width*height)));
+
+    return { width*scale, height*scale };
+}
+
+// Spawn the reproducible headless workload, circles spread over the whole world
+inline void SpawnHeadlessCircles(CircleSimulation &sim, int circleCount)
+{
+    SetRandomSeed(1234);                // Reproducible workload between runs
+
+    for (int i = 0; i < circleCount; i++)
+    {
+        Vector2 position = { (float)GetRandomValue(0, (int)sim.width), (float)GetRandomValue(0, (int)sim.height) };
+        SpawnRandomCircle(sim.circles, position);
+    }
+}
+
+// Run the simulation without a window for a fixed number of steps, returns the elapsed seconds
+// NOTE: Used as the profile-guided optimization training run (build_pgo.bat), so the workload
+// must stay representative of the windowed loop: same spawn pattern and a fixed 60 Hz step
+inline double RunHeadlessSimulation(int circleCount, int steps, float width, float height, bool mutualGravity = false)
+{
+    Vector2 world = HeadlessWorldSize(circleCount, width, height);
+    width = world.x;
+    height = world.y;
+
+    ThreadPool pool;
+    CircleSimulation sim(width, height, circleCount);
+    sim.pool = &pool;
+    sim.mutualGravity = mutualGravity;
+
+    SpawnHeadlessCircles(sim, circleCount);
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int step = 0; step < steps; step++) StepSimulation(sim, 1.0f/60.0f);
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    TraceLog(LOG_INFO, "SIM: %i circles (%.0fx%.0f), %i steps in %.3f s (%.3f ms/step, %i contacts, %i colors, %i threads%s)",
+        circleCount, width, height, steps, elapsed, elapsed*1000.0/steps, (int)sim.solver.ContactCount(),
+        sim.solver.ColorCount(), pool.ThreadCount(), mutualGravity? ", mutual gravity" : "");
+
+    return elapsed;
+}
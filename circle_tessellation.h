@@ -0,0 +1,96 @@
+#pragma once
+
+#include "raylib.h"
+#include "rlgl.h"
+
+#include "raymath_constexpr.h"
+
+#include <array>
+#include <cstddef>
+
+// Circle drawing from precomputed unit-circle vertex tables
+// DrawCircleV() evaluates sinf/cosf twice per segment of every circle, every frame; here the
+// unit circle of each supported segment count is built at compile time and a circle only costs
+// a scale and a translate per vertex. CircleBatchRenderer builds its vertex buffer from these
+// tables, EmitCircleTriangles() submits one circle straight to the rlgl batch
+// NOTE: The segment count is picked per radius so the polygon edge never deviates more than
+// circleMaxEdgeError pixels from the true circle; DrawCircleV() always uses 36 segments
+
+constexpr float circleMaxEdgeError = 0.25f;     // Max distance between a polygon edge and the circle (pixels)
+
+// Unit circle points for a segment count, the last point repeats the first
+template <int Segments>
+constexpr std::array<Vector2, Segments + 1> MakeUnitCircle()
+{
+    std::array<Vector2, Segments + 1> points = {};
+
+    for (int i = 0; i < Segments; i++)
+    {
+        float angle = 2.0f*PI*i/Segments;
+        points[i] = { cx::Cos(angle), cx::Sin(angle) };
+    }
+
+    points[Segments] = points[0];
+
+    return points;
+}
+
+template <int Segments>
+inline constexpr std::array<Vector2, Segments + 1> unitCirclePoints = MakeUnitCircle<Segments>();
+
+struct UnitCircleTable
+{
+    int segments;
+    const Vector2 *points;              // segments + 1 points
+    float maxRadius;                    // Largest radius drawn within circleMaxEdgeError
+};
+
+// Sagitta of one segment: radius*(1 - cos(PI/segments)) <= circleMaxEdgeError
+constexpr float UnitCircleMaxRadius(int segments)
+{
+    return circleMaxEdgeError/(1.0f - cx::Cos(PI/segments));
+}
+
+// Supported segment counts, ascending; circles larger than the last maxRadius use the last table
+inline constexpr UnitCircleTable unitCircleTables[] = {
+    { 8, unitCirclePoints<8>.data(), UnitCircleMaxRadius(8) },
+    { 12, unitCirclePoints<12>.data(), UnitCircleMaxRadius(12) },
+    { 16, unitCirclePoints<16>.data(), UnitCircleMaxRadius(16) },
+    { 24, unitCirclePoints<24>.data(), UnitCircleMaxRadius(24) },
+    { 36, unitCirclePoints<36>.data(), UnitCircleMaxRadius(36) },
+    { 48, unitCirclePoints<48>.data(), UnitCircleMaxRadius(48) },
+    { 64, unitCirclePoints<64>.data(), UnitCircleMaxRadius(64) },
+    { 96, unitCirclePoints<96>.data(), UnitCircleMaxRadius(96) },
+    { 128, unitCirclePoints<128>.data(), UnitCircleMaxRadius(128) },
+};
+
+constexpr int unitCircleTableCount = (int)(sizeof(unitCircleTables)/sizeof(unitCircleTables[0]));
+
+static_assert((unitCirclePoints<36>[0].x == 1.0f) && (unitCirclePoints<36>[9].y == 1.0f) && (unitCirclePoints<36>[36].x == 1.0f));
+static_assert((UnitCircleMaxRadius(16) > 12.0f) && (UnitCircleMaxRadius(16) < 14.0f));
+
+constexpr const UnitCircleTable &UnitCircleForRadius(float radius)
+{
+    for (int i = 0; i < unitCircleTableCount - 1; i++)
+    {
+        if (radius <= unitCircleTables[i].maxRadius) return unitCircleTables[i];
+    }
+
+    return unitCircleTables[unitCircleTableCount - 1];
+}
+
+// Emit the triangles of one circle, must be called between rlBegin(RL_TRIANGLES) and rlEnd()
+// NOTE: Same vertex order as DrawCircleSector(), rlgl only splits the batch at triangle boundaries
+inline void EmitCircleTriangles(Vector2 center, float radius, Color color, const UnitCircleTable &table)
+{
+    const Vector2 *points = table.points;
+
+    rlColor4ub(color.r, color.g, color.b, color.a);
+
+    for (int i = 0; i < table.segments; i++)
+    {
+        rlVertex2f(center.x, center.y);
+        rlVertex2f(center.x + points[i + 1].x*radius, center.y + points[i + 1].y*radius);
+        rlVertex2f(center.x + points[i].x*radius, center.y + points[i].y*radius);
+    }
+}
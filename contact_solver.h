@@ -0,0 +1,312 @@
+#pragma once
+
+#include "raylib.h"
+
+#include "circle_pool.h"
+#include "fast_math.h"
+#include "thread_pool.h"
+#include "uniform_grid.h"
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Impulse-based circle-vs-circle collision response
+// Mass is proportional to the circle area (radius squared), colliding circles exchange momentum
+// along the contact normal and the remaining overlap is removed by position correction
+//
+// Work is organized as gather -> compute -> scatter over structure-of-arrays contact data: the
+// compute passes are straight-line loops over float arrays (selects instead of branches) that the
+// compiler vectorizes, only the indexed gathers and scatters touch circles one at a time
+//
+// Contacts are graph colored before solving: no two contacts of the same color share a circle,
+// so each color is solved in parallel batches on the thread pool without locks or races, and
+// colors run one after another (Gauss-Seidel between colors)
+class ContactSolver
+{
+public:
+    float restitution = 0.8f;           // 0: perfectly inelastic, 1: perfectly elastic
+    int iterations = 4;                 // Velocity iterations, more converge better in dense piles
+    float slop = 0.05f;                 // Overlap tolerated without correction (pixels)
+    float correctionFactor = 0.8f;      // Fraction of the remaining overlap removed per step
+
+    // Build the contacts of the candidate pairs and resolve them, on the pool workers if provided
+    void Solve(CirclePool &circles, const std::vector<CirclePair> &pairs, ThreadPool *pool = nullptr)
+    {
+        ComputeInverseMasses(circles);
+        BuildContacts(circles, pairs);
+
+        if (contactA.empty())
+        {
+            colorStart.assign(1, 0);    // No colors, ColorCount() must not report the previous step
+            return;
+        }
+
+        ColorContacts(circles.Size());
+        PrepareContacts(circles);
+
+        for (int iteration = 0; iteration < iterations; iteration++)
+        {
+            ForEachColorBatch(pool, "SolveContacts", [&](size_t begin, size_t end) { SolveVelocityBatch(circles, begin, end); });
+        }
+
+        ForEachColorBatch(pool, "CorrectPositions", [&](size_t begin, size_t end) { CorrectPositions(circles, begin, end); });
+    }
+
+    size_t ContactCount() const { return contactA.size(); }
+    int ColorCount() const { return (int)colorStart.size() - 1; }
+
+private:
+    static constexpr size_t batchSize = 256;    // Contacts per gather/compute/scatter batch (fits L1)
+    static constexpr int maxColors = 64;        // Per-circle color masks are 64 bit, the last color is solved serially
+
+    // Run batch(begin, end) over every color in order, batches of one color in parallel
+    template <typename Batch>
+    void ForEachColorBatch(ThreadPool *pool, const char *name, Batch &&batch)
+    {
+        for (int color = 0; color < ColorCount(); color++)
+        {
+            size_t first = colorStart[color];
+            size_t count = colorStart[color + 1] - first;
+
+            // The overflow color may share circles between its contacts
+            if ((pool == nullptr) || (color == maxColors - 1))
+            {
+                for (size_t begin = 0; begin < count; begin += batchSize)
+                {
+                    batch(first + begin, first + std::min(begin + batchSize, count));
+                }
+            }
+            else pool->ParallelFor(name, count, batchSize, [&](size_t begin, size_t end) { batch(first + begin, first + end); });
+        }
+    }
+
+    void ComputeInverseMasses(const CirclePool &circles)
+    {
+        size_t count = circles.Size();
+        inverseMass.resize(count);
+
+        const float *radii = circles.radii.data();
+        float *inv = inverseMass.data();
+        for (size_t i = 0; i < count; i++) inv[i] = 1.0f/(radii[i]*radii[i]);
+    }
+
+    // Narrow phase: exact circle test over pair batches, touching pairs are compacted into contacts
+    void BuildContacts(const CirclePool &circles, const std::vector<CirclePair> &pairs)
+    {
+        contactA.clear();
+        contactB.clear();
+        normalX.clear();
+        normalY.clear();
+        penetration.clear();
+
+        float dx[batchSize], dy[batchSize], reach[batchSize], distance[batchSize];
+        float nx[batchSize], ny[batchSize], depth[batchSize];
+        bool touching[batchSize];
+
+        for (size_t begin = 0; begin < pairs.size(); begin += batchSize)
+        {
+            size_t n = (pairs.size() - begin < batchSize)? pairs.size() - begin : batchSize;
+            const CirclePair *batch = pairs.data() + begin;
+
+            // Gather
+            for (size_t k = 0; k < n; k++)
+            {
+                Vector2 pa = circles.positions[batch[k].a];
+                Vector2 pb = circles.positions[batch[k].b];
+                dx[k] = pb.x - pa.x;
+                dy[k] = pb.y - pa.y;
+                reach[k] = circles.radii[batch[k].a] + circles.radii[batch[k].b];
+            }
+
+            // Compute
+            for (size_t k = 0; k < n; k++)
+            {
+                float distanceSq = dx[k]*dx[k] + dy[k]*dy[k];
+                touching[k] = distanceSq < reach[k]*reach[k];
+
+                // Coincident centers get an arbitrary (+x) normal
+                bool degenerate = distanceSq < 1e-12f;
+#if defined(SIMULATION_FAST_MATH)
+                float invDistance = degenerate? 0.0f : FastRsqrt(distanceSq);
+                distance[k] = distanceSq*invDistance;
+#else
+                distance[k] = sqrtf(distanceSq);
+                float invDistance = degenerate? 0.0f : 1.0f/distance[k];
+#endif
+                nx[k] = degenerate? 1.0f : dx[k]*invDistance;
+                ny[k] = dy[k]*invDistance;
+                depth[k] = reach[k] - distance[k];
+            }
+
+            // Compact
+            for (size_t k = 0; k < n; k++)
+            {
+                if (!touching[k]) continue;
+
+                contactA.push_back(batch[k].a);
+                contactB.push_back(batch[k].b);
+                normalX.push_back(nx[k]);
+                normalY.push_back(ny[k]);
+                penetration.push_back(depth[k]);
+            }
+        }
+
+    }
+
+    // Greedy coloring: each contact takes the lowest color free on both of its circles, then the
+    // contacts are reordered so every color is a contiguous range [colorStart[c], colorStart[c + 1])
+    void ColorContacts(size_t circleCount)
+    {
+        size_t count = contactA.size();
+
+        usedColors.assign(circleCount, 0);
+        contactColor.resize(count);
+        colorStart.assign(maxColors + 1, 0);
+
+        for (size_t c = 0; c < count; c++)
+        {
+            uint64_t used = usedColors[contactA[c]] | usedColors[contactB[c]];
+            int color = (used == UINT64_MAX)? maxColors - 1 : std::countr_one(used);
+
+            usedColors[contactA[c]] |= (uint64_t)1 << color;
+            usedColors[contactB[c]] |= (uint64_t)1 << color;
+            contactColor[c] = (uint8_t)color;
+            colorStart[color + 1]++;
+        }
+
+        int colors = maxColors;
+        while ((colors > 0) && (colorStart[colors] == 0)) colors--;
+        colorStart.resize(colors + 1);
+
+        for (int color = 1; color <= colors; color++) colorStart[color] += colorStart[color - 1];
+
+        // Counting sort of the contact arrays by color
+        order.resize(count);
+        colorCursor.assign(colorStart.begin(), colorStart.end() - 1);
+        for (size_t c = 0; c < count; c++) order[colorCursor[contactColor[c]]++] = (uint32_t)c;
+
+        Permute(contactA, scratchIndices);
+        Permute(contactB, scratchIndices);
+        Permute(normalX, scratchFloats);
+        Permute(normalY, scratchFloats);
+        Permute(penetration, scratchFloats);
+    }
+
+    template <typename T>
+    void Permute(std::vector<T> &values, std::vector<T> &scratch) const
+    {
+        scratch.resize(values.size());
+        for (size_t i = 0; i < order.size(); i++) scratch[i] = values[order[i]];
+        values.swap(scratch);
+    }
+
+    // Effective mass and restitution target from the approach velocity before solving
+    void PrepareContacts(const CirclePool &circles)
+    {
+        size_t count = contactA.size();
+        massNormal.resize(count);
+        targetVelocity.resize(count);
+        accumulated.assign(count, 0.0f);
+
+        for (size_t begin = 0; begin < count; begin += batchSize)
+        {
+            size_t end = (begin + batchSize < count)? begin + batchSize : count;
+            float vn[batchSize], inverseSum[batchSize];
+
+            GatherNormalVelocity(circles, begin, end, vn, inverseSum);
+
+            for (size_t k = 0; k < end - begin; k++)
+            {
+                massNormal[begin + k] = 1.0f/inverseSum[k];
+                targetVelocity[begin + k] = -restitution*fminf(vn[k], 0.0f);
+            }
+        }
+    }
+
+    // Relative velocity along the normal (negative when approaching) and inverse mass sum
+    void GatherNormalVelocity(const CirclePool &circles, size_t begin, size_t end, float *vn, float *inverseSum) const
+    {
+        for (size_t c = begin; c < end; c++)
+        {
+            Vector2 va = circles.velocities[contactA[c]];
+            Vector2 vb = circles.velocities[contactB[c]];
+            vn[c - begin] = (vb.x - va.x)*normalX[c] + (vb.y - va.y)*normalY[c];
+            inverseSum[c - begin] = inverseMass[contactA[c]] + inverseMass[contactB[c]];
+        }
+    }
+
+    // Sequential impulses with accumulated clamping, contacts in [begin, end)
+    void SolveVelocityBatch(CirclePool &circles, size_t begin, size_t end)
+    {
+        size_t n = end - begin;
+        float vn[batchSize], inverseSum[batchSize], impulse[batchSize];
+
+        GatherNormalVelocity(circles, begin, end, vn, inverseSum);
+
+        float *acc = accumulated.data() + begin;
+        const float *mass = massNormal.data() + begin;
+        const float *target = targetVelocity.data() + begin;
+
+        for (size_t k = 0; k < n; k++)
+        {
+            float lambda = (target[k] - vn[k])*mass[k];
+            float total = fmaxf(acc[k] + lambda, 0.0f);    // Contacts push, never pull
+            impulse[k] = total - acc[k];
+            acc[k] = total;
+        }
+
+        for (size_t k = 0; k < n; k++)
+        {
+            uint32_t a = contactA[begin + k];
+            uint32_t b = contactB[begin + k];
+            float px = impulse[k]*normalX[begin + k];
+            float py = impulse[k]*normalY[begin + k];
+
+            circles.velocities[a].x -= px*inverseMass[a];
+            circles.velocities[a].y -= py*inverseMass[a];
+            circles.velocities[b].x += px*inverseMass[b];
+            circles.velocities[b].y += py*inverseMass[b];
+        }
+    }
+
+    // Push overlapping circles apart, split by inverse mass so light circles move more
+    void CorrectPositions(CirclePool &circles, size_t begin, size_t end)
+    {
+        for (size_t c = begin; c < end; c++)
+        {
+            uint32_t a = contactA[c];
+            uint32_t b = contactB[c];
+            float correction = fmaxf(penetration[c] - slop, 0.0f)*correctionFactor*massNormal[c];
+            float cx = correction*normalX[c];
+            float cy = correction*normalY[c];
+
+            circles.positions[a].x -= cx*inverseMass[a];
+            circles.positions[a].y -= cy*inverseMass[a];
+            circles.positions[b].x += cx*inverseMass[b];
+            circles.positions[b].y += cy*inverseMass[b];
+        }
+    }
+
+    std::vector<float> inverseMass;     // Per circle, dense order
+
+    // Contacts, structure of arrays
+    std::vector<uint32_t> contactA;
+    std::vector<uint32_t> contactB;
+    std::vector<float> normalX;         // Unit normal from A to B
+    std::vector<float> normalY;
+    std::vector<float> penetration;
+    std::vector<float> massNormal;      // Effective mass along the normal
+    std::vector<float> targetVelocity;  // Separating velocity required by restitution
+    std::vector<float> accumulated;     // Accumulated normal impulse, clamped to >= 0
+
+    // Coloring
+    std::vector<uint64_t> usedColors;   // Per circle, bit c set when a contact of color c touches it
+    std::vector<uint8_t> contactColor;
+    std::vector<size_t> colorStart = { 0 };     // First contact of each color, colorStart[c + 1] is one past its last
+    std::vector<size_t> colorCursor;
+    std::vector<uint32_t> order;        // Sorted position -> original contact index
+    std::vector<uint32_t> scratchIndices;
+    std::vector<float> scratchFloats;
+};
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "thread_pool.h"
+#include "trace.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// CPU stand-in for rlgl compute shaders, for machines without a compute capable GPU
+// Same model as rlComputeShaderDispatch(): a kernel declares its work group size, a dispatch
+// launches a grid of groups, every invocation gets its global, local and group ids and reads and
+// writes storage bound to numbered binding points (SSBO style). The storage is memory the caller
+// already owns, e.g. the arrays of a structure-of-arrays pool, so nothing is uploaded or copied.
+// Work groups run on the ThreadPool workers, the invocations of one group run in order on one thread
+// NOTE: There is no shared memory or barrier() inside a group, kernels needing them must be split
+// into several dispatches; like on the GPU, kernels bounds-check their global id themselves
+
+struct ComputeUint3
+{
+    uint32_t x;
+    uint32_t y;
+    uint32_t z;
+};
+
+// gl_GlobalInvocationID, gl_LocalInvocationID, gl_WorkGroupID and gl_LocalInvocationIndex
+struct ComputeInvocation
+{
+    ComputeUint3 globalId;
+    ComputeUint3 localId;
+    ComputeUint3 groupId;
+    uint32_t localIndex;
+};
+
+// Kernel program: name (traced), work group size and body(const ComputeInvocation &, const ComputeBindings &)
+// e.g. ComputeKernel integrate { "Integrate", { 64, 1, 1 }, [&](const ComputeInvocation &id, const ComputeBindings &buffers) { ... } };
+template <typename Body>
+struct ComputeKernel
+{
+    const char *name;
+    ComputeUint3 localSize;
+    Body body;
+};
+
+// What a kernel sees of a bound buffer
+struct ComputeBinding
+{
+    void *data = nullptr;
+    size_t size = 0;                    // Bytes
+
+    template <typename T> T *As() const { return (T *)data; }
+    template <typename T> size_t Count() const { return size/sizeof(T); }
+};
+
+struct ComputeBindings
+{
+    static constexpr int maxBindings = 8;
+
+    ComputeBinding slots[maxBindings];
+
+    const ComputeBinding &operator[](int index) const { return slots[index]; }
+};
+
+// Binds storage and dispatches kernels over a ThreadPool (single-threaded when the pool is null)
+class ComputeDispatcher
+{
+public:
+    explicit ComputeDispatcher(ThreadPool *pool = nullptr) : pool(pool) {}
+
+    void BindStorage(int index, void *data, size_t size) { bindings.slots[index] = { data, size }; }
+
+    template <typename T>
+    void BindStorage(int index, std::vector<T> &values) { BindStorage(index, values.data(), values.size()*sizeof(T)); }
+
+    // Groups needed to cover count invocations along one axis
+    static uint32_t GroupCount(size_t count, uint32_t localSize) { return (uint32_t)((count + localSize - 1)/localSize); }
+
+    // Run groupX*groupY*groupZ work groups of the kernel, returns once every invocation ran
+    template <typename Body>
+    void Dispatch(const ComputeKernel<Body> &kernel, uint32_t groupX, uint32_t groupY = 1, uint32_t groupZ = 1)
+    {
+        size_t groupCount = (size_t)groupX*groupY*groupZ;
+        size_t groupSize = (size_t)kernel.localSize.x*kernel.localSize.y*kernel.localSize.z;
+        if ((groupCount == 0) || (groupSize == 0)) return;
+
+        // Enough groups per chunk to amortize the chunk overhead
+        size_t grain = (minChunkInvocations + groupSize - 1)/groupSize;
+
+        auto runGroups = [&](size_t begin, size_t end) {
+            for (size_t group = begin; group < end; group++) RunGroup(kernel, group, groupX, groupY);
+        };
+
+        if (pool != nullptr) pool->ParallelFor(kernel.name, groupCount, grain, runGroups);
+        else
+        {
+            TRACE_SCOPE(kernel.name);
+            runGroups(0, groupCount);
+        }
+    }
+
+private:
+    static constexpr size_t minChunkInvocations = 2048;
+
+    template <typename Body>
+    void RunGroup(const ComputeKernel<Body> &kernel, size_t group, uint32_t groupX, uint32_t groupY) const
+    {
+        ComputeUint3 size = kernel.localSize;
+        ComputeBindings buffers = bindings;     // Local copy: kernel stores cannot alias it, binding pointers stay in registers
+
+        ComputeInvocation id = {};
+        id.groupId = { (uint32_t)(group%groupX), (uint32_t)((group/groupX)%groupY), (uint32_t)(group/((size_t)groupX*groupY)) };
+
+        for (uint32_t z = 0; z < size.z; z++)
+        {
+            for (uint32_t y = 0; y < size.y; y++)
+            {
+                for (uint32_t x = 0; x < size.x; x++)
+                {
+                    id.localId = { x, y, z };
+                    id.globalId = { id.groupId.x*size.x + x, id.groupId.y*size.y + y, id.groupId.z*size.z + z };
+                    id.localIndex = (z*size.y + y)*size.x + x;
+
+                    kernel.body(id, buffers);
+                }
+            }
+        }
+    }
+
+    ThreadPool *pool;
+    ComputeBindings bindings;
+};
@@ -0,0 +1,121 @@
+#pragma once
+
+// Fast approximate replacements for the raymath functions used by the simulation
+//
+// Opt-in and meant for simulation only (collision normals, velocity rotation, distances), never
+// for rendering transforms or anything accumulated over long periods. Build with
+// -DSIMULATION_FAST_MATH to switch the simulation hot paths to these functions
+//
+// Error bounds, measured over the full float range for rsqrt and over [-100, 100] rad for the
+// trigonometric functions:
+//   FastRsqrt                   relative error < 1.8e-3 (bit-trick estimate + one Newton step)
+//   FastVector2Length           relative error < 1.8e-3
+//   FastVector2Normalize        length of the result within 1.8e-3 of 1, direction exact
+//   FastSin, FastCos            absolute error < 1e-6 (degree-7 minimax polynomial)
+//   FastSinCos (table)          absolute error < 5e-6 (1024-entry table, linear interpolation)
+//   FastVector2Rotate           absolute error < 5e-6 per unit length of v
+
+#include "raylib.h"
+
+#include "raymath_constexpr.h"
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+// Approximate 1/sqrt(x) for x > 0, returns a large finite value for x = 0
+inline float FastRsqrt(float x)
+{
+    float half = 0.5f*x;
+    float y = std::bit_cast<float>(0x5f375a86u - (std::bit_cast<uint32_t>(x) >> 1));
+    y = y*(1.5f - half*y*y);        // One Newton-Raphson step
+
+    return y;
+}
+
+inline float FastVector2Length(Vector2 v)
+{
+    float lengthSq = v.x*v.x + v.y*v.y;
+    return (lengthSq > 0.0f)? lengthSq*FastRsqrt(lengthSq) : 0.0f;
+}
+
+// Same contract as Vector2Normalize(): the zero vector stays zero
+inline Vector2 FastVector2Normalize(Vector2 v)
+{
+    float lengthSq = v.x*v.x + v.y*v.y;
+    float inverse = (lengthSq > 0.0f)? FastRsqrt(lengthSq) : 0.0f;
+
+    return { v.x*inverse, v.y*inverse };
+}
+
+// Reduce an angle to [-PI, PI]
+// NOTE: 2*PI is split in an exactly representable head and a small tail (Cody-Waite), a single
+// float constant would add ~2e-7 of error per turn removed
+inline float FastAngleReduce(float x)
+{
+    float turns = nearbyintf(x*0.159154943091895335769f);
+
+    x -= turns*6.28125f;
+    x -= turns*0.00193530717958647692f;
+
+    return x;
+}
+
+inline float FastSin(float x)
+{
+    const float halfPi = 1.57079632679489661923f;
+
+    x = FastAngleReduce(x);
+    if (x > halfPi) x = PI - x;                      // sin(PI - x) = sin(x)
+    else if (x < -halfPi) x = -PI - x;
+
+    float x2 = x*x;
+
+    // Minimax odd polynomial on [-PI/2, PI/2]
+    return x*(0.9999966f + x2*(-0.16664824f + x2*(0.00830629f + x2*(-0.00018363f))));
+}
+
+inline float FastCos(float x)
+{
+    return FastSin(FastAngleReduce(x) + 1.57079632679489661923f);     // Reduce first, adding PI/2 to a large x rounds
+}
+
+// Table-based sine and cosine, cheaper than the polynomials when both are needed
+constexpr int fastSinTableSize = 1024;
+
+struct FastSinTable
+{
+    float values[fastSinTableSize + 1];     // sin over one turn, last entry repeats the first
+
+    constexpr FastSinTable() : values()
+    {
+        for (int i = 0; i <= fastSinTableSize; i++) values[i] = cx::Sin(2.0f*PI*i/fastSinTableSize);
+    }
+};
+
+inline constexpr FastSinTable fastSinTable;         // Built at compile time, no static initializer
+
+inline void FastSinCos(float angle, float *sine, float *cosine)
+{
+    const float turnsToTable = fastSinTableSize/(2.0f*PI);
+
+    float position = FastAngleReduce(angle)*turnsToTable;
+    float floorPosition = floorf(position);
+    float t = position - floorPosition;
+
+    // Quarter turn offset gives the cosine from the same table
+    int index = (int)((int64_t)floorPosition & (fastSinTableSize - 1));
+    int cosIndex = (index + fastSinTableSize/4) & (fastSinTableSize - 1);
+
+    *sine = fastSinTable.values[index] + t*(fastSinTable.values[index + 1] - fastSinTable.values[index]);
+    *cosine = fastSinTable.values[cosIndex] + t*(fastSinTable.values[cosIndex + 1] - fastSinTable.values[cosIndex]);
+}
+
+// Same contract as Vector2Rotate(): counter-clockwise in radians
+inline Vector2 FastVector2Rotate(Vector2 v, float angle)
+{
+    float sine, cosine;
+    FastSinCos(angle, &sine, &cosine);
+
+    return { v.x*cosine - v.y*sine, v.x*sine + v.y*cosine };
+}
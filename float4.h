@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #define FLOAT4_SSE2
+    #include <emmintrin.h>
+#endif
+
+// Four float lanes (pixels of a row group, particles of a batch); SSE2 when available, plain arrays otherwise
+// NOTE: Load()/Store() need 16 byte aligned pointers, LoadUnaligned()/StoreUnaligned() do not
+struct Float4
+{
+#if defined(FLOAT4_SSE2)
+    __m128 v;
+
+    static Float4 Set1(float x) { return { _mm_set1_ps(x) }; }
+    static Float4 Set(float x0, float x1, float x2, float x3) { return { _mm_setr_ps(x0, x1, x2, x3) }; }
+    static Float4 Load(const float *p) { return { _mm_load_ps(p) }; }
+    static Float4 LoadUnaligned(const float *p) { return { _mm_loadu_ps(p) }; }
+    void Store(float *p) const { _mm_store_ps(p, v); }
+    void StoreUnaligned(float *p) const { _mm_storeu_ps(p, v); }
+
+    friend Float4 operator+(Float4 a, Float4 b) { return { _mm_add_ps(a.v, b.v) }; }
+    friend Float4 operator-(Float4 a, Float4 b) { return { _mm_sub_ps(a.v, b.v) }; }
+    friend Float4 operator*(Float4 a, Float4 b) { return { _mm_mul_ps(a.v, b.v) }; }
+    friend Float4 operator/(Float4 a, Float4 b) { return { _mm_div_ps(a.v, b.v) }; }
+    friend Float4 Sqrt(Float4 a) { return { _mm_sqrt_ps(a.v) }; }
+    friend Float4 Min(Float4 a, Float4 b) { return { _mm_min_ps(a.v, b.v) }; }
+    friend Float4 Max(Float4 a, Float4 b) { return { _mm_max_ps(a.v, b.v) }; }
+    friend Float4 Clamp01(Float4 a) { return { _mm_min_ps(_mm_max_ps(a.v, _mm_setzero_ps()), _mm_set1_ps(1.0f)) }; }
+#else
+    float v[4];
+
+    static Float4 Set1(float x) { return { { x, x, x, x } }; }
+    static Float4 Set(float x0, float x1, float x2, float x3) { return { { x0, x1, x2, x3 } }; }
+    static Float4 Load(const float *p) { return { { p[0], p[1], p[2], p[3] } }; }
+    static Float4 LoadUnaligned(const float *p) { return Load(p); }
+    void Store(float *p) const { for (int i = 0; i < 4; i++) p[i] = v[i]; }
+    void StoreUnaligned(float *p) const { Store(p); }
+
+    friend Float4 operator+(Float4 a, Float4 b) { for (int i = 0; i < 4; i++) a.v[i] += b.v[i]; return a; }
+    friend Float4 operator-(Float4 a, Float4 b) { for (int i = 0; i < 4; i++) a.v[i] -= b.v[i]; return a; }
+    friend Float4 operator*(Float4 a, Float4 b) { for (int i = 0; i < 4; i++) a.v[i] *= b.v[i]; return a; }
+    friend Float4 operator/(Float4 a, Float4 b) { for (int i = 0; i < 4; i++) a.v[i] /= b.v[i]; return a; }
+    friend Float4 Sqrt(Float4 a) { for (int i = 0; i < 4; i++) a.v[i] = sqrtf(a.v[i]); return a; }
+    friend Float4 Min(Float4 a, Float4 b) { for (int i = 0; i < 4; i++) a.v[i] = fminf(a.v[i], b.v[i]); return a; }
+    friend Float4 Max(Float4 a, Float4 b) { for (int i = 0; i < 4; i++) a.v[i] = fmaxf(a.v[i], b.v[i]); return a; }
+    friend Float4 Clamp01(Float4 a) { for (int i = 0; i < 4; i++) a.v[i] = fminf(fmaxf(a.v[i], 0.0f), 1.0f); return a; }
+#endif
+
+    float Sum() const
+    {
+        alignas(16) float lanes[4];
+        Store(lanes);
+        return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    }
+};
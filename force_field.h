@@ -0,0 +1,206 @@
+#pragma once
+
+#include "raylib.h"
+
+#include "circle_pool.h"
+#include "cpu_compute.h"
+#include "thread_pool.h"
+
+#include <cmath>
+#include <vector>
+
+enum ForceFieldType {
+    FORCE_FIELD_POINT = 0,              // Attractor (strength > 0) or repulsor (strength < 0)
+    FORCE_FIELD_WIND,                   // Uniform acceleration along direction
+    FORCE_FIELD_VORTEX                  // Swirl around position, counter-clockwise on screen for strength > 0
+};
+
+// Acceleration source acting on every circle
+// Point and vortex fields follow strength*s(d/radius) with s(x) = 27/4*x*(1 - x)^2: zero at the
+// center (no direction flip to resolve) and at radius, peaking at radius/3. Continuous fields are
+// what keeps the grid interpolation accurate
+struct ForceField
+{
+    ForceFieldType type;
+    Vector2 position;                   // Point and vortex center
+    Vector2 direction;                  // Wind direction (normalized)
+    float strength;                     // Peak acceleration (pixels/s^2), reached at radius/3
+    float radius;                       // Point and vortex reach (pixels)
+};
+
+// Acceleration of a single field at a point
+inline Vector2 EvaluateForceField(const ForceField &field, Vector2 point)
+{
+    if (field.type == FORCE_FIELD_WIND) return { field.direction.x*field.strength, field.direction.y*field.strength };
+
+    float dx = field.position.x - point.x;
+    float dy = field.position.y - point.y;
+    float distanceSq = dx*dx + dy*dy;
+    if (distanceSq >= field.radius*field.radius) return { 0.0f, 0.0f };
+
+    // Direction is (dx, dy)/distance, the profile's x factor cancels the division
+    float falloff = 1.0f - sqrtf(distanceSq)/field.radius;
+    float scale = field.strength*6.75f*falloff*falloff/field.radius;
+
+    // Toward the center for points, perpendicular to it for vortices
+    if (field.type == FORCE_FIELD_POINT) return { dx*scale, dy*scale };
+    else return { -dy*scale, dx*scale };
+}
+
+// Set of force fields applied to the circle accelerations
+// Summing M fields for each of N circles costs O(N*M) every step. Instead, the summed field is
+// evaluated once on the nodes of a coarse grid covering the world, and every circle bilinearly
+// interpolates the four nodes around it, O(N) per step. The grid is only re-evaluated, in
+// parallel, when a field or the world size changes, so static fields cost nothing after setup
+// NOTE: Features smaller than a cell are smoothed out, keep field radii a few cells wide
+class ForceFields
+{
+public:
+    float cellSize = 16.0f;             // Grid node spacing (pixels), a change rebuilds the grid
+    bool useGrid = true;                // false evaluates every field for every circle (reference)
+
+    int Add(const ForceField &field)
+    {
+        fields.push_back(field);
+        dirty = true;
+        return (int)fields.size() - 1;
+    }
+
+    void Set(int index, const ForceField &field)
+    {
+        fields[index] = field;
+        dirty = true;
+    }
+
+    // Swap-remove, the last field takes index
+    void Remove(int index)
+    {
+        fields[index] = fields.back();
+        fields.pop_back();
+        dirty = true;
+    }
+
+    void Clear()
+    {
+        fields.clear();
+        dirty = true;
+    }
+
+    size_t Count() const { return fields.size(); }
+    bool Empty() const { return fields.empty(); }
+    const ForceField &Get(int index) const { return fields[index]; }
+
+    // Exact summed acceleration at a point
+    Vector2 Evaluate(Vector2 point) const
+    {
+        Vector2 acceleration = { 0.0f, 0.0f };
+
+        for (const ForceField &field : fields)
+        {
+            Vector2 a = EvaluateForceField(field, point);
+            acceleration.x += a.x;
+            acceleration.y += a.y;
+        }
+
+        return acceleration;
+    }
+
+    // Overwrite every circle acceleration with the summed field at its position
+    void Apply(CirclePool &circles, float width, float height, ThreadPool *pool = nullptr)
+    {
+        ComputeDispatcher compute(pool);
+        compute.BindStorage(FORCE_BINDING_POSITIONS, circles.positions);
+        compute.BindStorage(FORCE_BINDING_ACCELERATIONS, circles.accelerations);
+
+        size_t count = circles.Size();
+
+        if (!useGrid || fields.empty())
+        {
+            ComputeKernel evaluate { "EvaluateForceFields", { 256, 1, 1 }, [this, count](const ComputeInvocation &id, const ComputeBindings &buffers) {
+                size_t i = id.globalId.x;
+                if (i >= count) return;
+
+                buffers[FORCE_BINDING_ACCELERATIONS].As<Vector2>()[i] = Evaluate(buffers[FORCE_BINDING_POSITIONS].As<Vector2>()[i]);
+            } };
+
+            compute.Dispatch(evaluate, ComputeDispatcher::GroupCount(count, evaluate.localSize.x));
+            return;
+        }
+
+        if (dirty || (width != gridWidth) || (height != gridHeight) || (cellSize != gridCellSize)) BuildGrid(compute, width, height);
+
+        ComputeKernel sample { "SampleForceGrid", { 256, 1, 1 }, [this, count](const ComputeInvocation &id, const ComputeBindings &buffers) {
+            size_t i = id.globalId.x;
+            if (i >= count) return;
+
+            buffers[FORCE_BINDING_ACCELERATIONS].As<Vector2>()[i] = Sample(buffers[FORCE_BINDING_POSITIONS].As<Vector2>()[i]);
+        } };
+
+        compute.Dispatch(sample, ComputeDispatcher::GroupCount(count, sample.localSize.x));
+    }
+
+    // Bilinear interpolation of the grid nodes, positions outside the world clamp to its border
+    Vector2 Sample(Vector2 point) const
+    {
+        float gx = fminf(fmaxf(point.x*inverseCellSize, 0.0f), (float)(columns - 1));
+        float gy = fminf(fmaxf(point.y*inverseCellSize, 0.0f), (float)(rows - 1));
+
+        int x0 = (int)gx;
+        int y0 = (int)gy;
+        if (x0 > columns - 2) x0 = columns - 2;
+        if (y0 > rows - 2) y0 = rows - 2;
+
+        float fx = gx - (float)x0;
+        float fy = gy - (float)y0;
+
+        const Vector2 *row0 = nodes.data() + (size_t)y0*columns + x0;
+        const Vector2 *row1 = row0 + columns;
+
+        Vector2 top = { row0[0].x + (row0[1].x - row0[0].x)*fx, row0[0].y + (row0[1].y - row0[0].y)*fx };
+        Vector2 bottom = { row1[0].x + (row1[1].x - row1[0].x)*fx, row1[0].y + (row1[1].y - row1[0].y)*fx };
+
+        return { top.x + (bottom.x - top.x)*fy, top.y + (bottom.y - top.y)*fy };
+    }
+
+private:
+    enum ForceBinding {
+        FORCE_BINDING_POSITIONS = 0,
+        FORCE_BINDING_ACCELERATIONS,
+        FORCE_BINDING_NODES
+    };
+
+    // Evaluate every field on every node, one invocation per node
+    void BuildGrid(ComputeDispatcher &compute, float width, float height)
+    {
+        gridWidth = width;
+        gridHeight = height;
+        gridCellSize = cellSize;
+        inverseCellSize = 1.0f/gridCellSize;
+        columns = (int)ceilf(width/gridCellSize) + 1;   // Nodes, one more than cells
+        rows = (int)ceilf(height/gridCellSize) + 1;
+        nodes.resize((size_t)columns*rows);
+
+        compute.BindStorage(FORCE_BINDING_NODES, nodes);
+
+        ComputeKernel evaluateNodes { "EvaluateForceGrid", { 16, 16, 1 }, [this](const ComputeInvocation &id, const ComputeBindings &buffers) {
+            if (((int)id.globalId.x >= columns) || ((int)id.globalId.y >= rows)) return;
+
+            Vector2 node = { id.globalId.x*gridCellSize, id.globalId.y*gridCellSize };
+            buffers[FORCE_BINDING_NODES].As<Vector2>()[(size_t)id.globalId.y*columns + id.globalId.x] = Evaluate(node);
+        } };
+
+        compute.Dispatch(evaluateNodes, ComputeDispatcher::GroupCount(columns, 16), ComputeDispatcher::GroupCount(rows, 16));
+        dirty = false;
+    }
+
+    std::vector<ForceField> fields;
+
+    std::vector<Vector2> nodes;         // Summed field at (x*gridCellSize, y*gridCellSize), columns x rows
+    int columns = 0;
+    int rows = 0;
+    float inverseCellSize = 0.0f;
+    float gridWidth = 0.0f;             // World size and cell size the grid was built for
+    float gridHeight = 0.0f;
+    float gridCellSize = 0.0f;
+    bool dirty = true;
+};
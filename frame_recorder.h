@@ -0,0 +1,285 @@
+#pragma once
+
+#include "raylib.h"
+
+#include "trace.h"
+
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+    #define FRAME_RECORDER_POPEN _popen
+    #define FRAME_RECORDER_PCLOSE _pclose
+    #define FRAME_RECORDER_PIPE_MODE "wb"       // Text mode pipes would translate newline bytes
+#else
+    #define FRAME_RECORDER_POPEN popen
+    #define FRAME_RECORDER_PCLOSE pclose
+    #define FRAME_RECORDER_PIPE_MODE "w"
+#endif
+
+// Whether a user supplied file name can be used as the printf format of a numbered frame: exactly
+// one int conversion (%i, %05d, ...) and nothing else but literal "%%"
+inline bool IsFrameNumberPattern(const char *pattern)
+{
+    int conversions = 0;
+
+    for (const char *c = pattern; *c != '\0'; c++)
+    {
+        if (*c != '%') continue;
+        if (*(++c) == '%') continue;
+
+        while ((*c == '-') || (*c == '+') || (*c == ' ') || (*c == '#') || (*c == '0')) c++;
+        while ((*c >= '0') && (*c <= '9')) c++;
+        if (*c == '.')
+        {
+            c++;
+            while ((*c >= '0') && (*c <= '9')) c++;
+        }
+
+        // No length modifiers, '*' or other conversions: the only argument is one int
+        if ((*c != 'd') && (*c != 'i')) return false;
+        conversions++;
+    }
+
+    return (conversions == 1);
+}
+
+// Streams frames as raw RGBA (8 bits per channel, top row first) from a dedicated writer thread
+// Submit() copies the frame into the next buffer of a bounded ring of reusable buffers and
+// returns, the writer thread does the file or pipe I/O in submission order. When every buffer
+// is queued Submit() waits for the writer instead of dropping the frame, the stall is counted
+// and reported on Close(). The writer thread is started by the first Open() and kept across
+// recordings until the recorder is destroyed
+// Targets:
+//   "|command"         pipe to a process, e.g. "|ffmpeg -f rawvideo -pix_fmt rgba -s 1920x1080 -r 60 -i - out.mp4"
+//   "frame_%05i.rgba"  one file per frame (printf pattern with a single int conversion, the frame number)
+//   "recording.rgba"   every frame appended to one file
+class FrameRecorder
+{
+public:
+    FrameRecorder() = default;
+
+    ~FrameRecorder()
+    {
+        Close();
+
+        if (writer.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            frameQueued.notify_one();
+            writer.join();
+        }
+    }
+
+    FrameRecorder(const FrameRecorder &) = delete;
+    FrameRecorder &operator=(const FrameRecorder &) = delete;
+
+    bool Open(const char *target, int frameWidth, int frameHeight, int bufferCount = 4)
+    {
+        Close();
+
+        // Pipe commands go to the shell as they are, only file names are used as a format
+        bool pipe = (target[0] == '|');
+        bool sequence = !pipe && (strchr(target, '%') != nullptr);
+        if (sequence && !IsFrameNumberPattern(target))
+        {
+            TraceLog(LOG_WARNING, "RECORD: %s must contain exactly one frame number conversion (e.g. %%05i)", target);
+            return false;
+        }
+
+        width = frameWidth;
+        height = frameHeight;
+        isPipe = pipe;
+        isSequence = sequence;
+        snprintf(targetName, sizeof(targetName), "%s", isPipe? target + 1 : target);
+
+        if (!isSequence)
+        {
+            output = isPipe? FRAME_RECORDER_POPEN(targetName, FRAME_RECORDER_PIPE_MODE) : fopen(targetName, "wb");
+            if (output == nullptr)
+            {
+                TraceLog(LOG_WARNING, "RECORD: Failed to open %s", target);
+                return false;
+            }
+        }
+
+        // The writer is idle between recordings (nothing queued), it does not touch the ring
+        buffers.assign(bufferCount, std::vector<unsigned char>((size_t)width*height*4));
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            submitted = 0;
+            written = 0;
+            stalls = 0;
+            failed = false;
+        }
+
+        if (!writer.joinable()) writer = std::thread([this]() { WriterLoop(); });
+        recording = true;
+
+        TraceLog(LOG_INFO, "RECORD: Recording %ix%i raw RGBA frames to %s", width, height, target);
+        return true;
+    }
+
+    bool IsOpen() const { return recording; }
+
+    // Queue a frame for writing; the image must be width x height, R8G8B8A8 or R8G8B8
+    void Submit(const Image &frame)
+    {
+        if ((frame.width != width) || (frame.height != height)) return;
+
+        SubmitPixels([&](unsigned char *pixels) { CopyPixels(frame, pixels); });
+    }
+
+    // Queue a frame written by fill(unsigned char *pixels) straight into the next ring buffer,
+    // width x height RGBA pixels top row first, e.g. ReadScreenPixels() without an Image copy
+    template <typename Fill>
+    void SubmitPixels(Fill &&fill)
+    {
+        if (!IsOpen()) return;
+
+        TRACE_SCOPE("RecordSubmit");
+
+        int bufferCount = (int)buffers.size();
+        int index = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            if (submitted - written == bufferCount)
+            {
+                stalls++;
+                TRACE_SCOPE("RecordStall");
+                bufferFreed.wait(lock, [&]() { return submitted - written < bufferCount; });
+            }
+
+            index = submitted%bufferCount;
+        }
+
+        // The buffer is not published yet, the writer does not touch it
+        fill(buffers[index].data());
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            submitted++;
+        }
+        frameQueued.notify_one();
+    }
+
+    // Write every queued frame and close the target
+    void Close()
+    {
+        if (!IsOpen()) return;
+
+        recording = false;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            bufferFreed.wait(lock, [&]() { return written == submitted; });
+        }
+
+        if (output != nullptr)
+        {
+            if (isPipe) FRAME_RECORDER_PCLOSE(output);
+            else fclose(output);
+            output = nullptr;
+        }
+
+        TraceLog(failed? LOG_WARNING : LOG_INFO, "RECORD: %i frames written to %s, %i submit stalls%s",
+            written, targetName, stalls, failed? " (write errors)" : "");
+
+        buffers.clear();
+    }
+
+private:
+    void CopyPixels(const Image &frame, unsigned char *dst) const
+    {
+        size_t pixelCount = (size_t)width*height;
+        const unsigned char *src = (const unsigned char *)frame.data;
+
+        if (frame.format == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8) memcpy(dst, src, pixelCount*4);
+        else if (frame.format == PIXELFORMAT_UNCOMPRESSED_R8G8B8)
+        {
+            for (size_t i = 0; i < pixelCount; i++)
+            {
+                dst[i*4 + 0] = src[i*3 + 0];
+                dst[i*4 + 1] = src[i*3 + 1];
+                dst[i*4 + 2] = src[i*3 + 2];
+                dst[i*4 + 3] = 255;
+            }
+        }
+        else memset(dst, 0, pixelCount*4);
+    }
+
+    void WriterLoop()
+    {
+        TraceSetThreadName("Recorder");
+
+        for (;;)
+        {
+            int number = 0;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                frameQueued.wait(lock, [&]() { return stopping || (written < submitted); });
+                if (written == submitted) return;           // Destroying, Close() already drained the queue
+
+                number = written;
+            }
+
+            {
+                TRACE_SCOPE("RecordWrite");
+                if (!WriteFrame(buffers[number%buffers.size()], number)) failed = true;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                written++;
+            }
+            bufferFreed.notify_one();
+        }
+    }
+
+    bool WriteFrame(const std::vector<unsigned char> &pixels, int number)
+    {
+        if (!isSequence) return fwrite(pixels.data(), 1, pixels.size(), output) == pixels.size();
+
+        char fileName[512];
+        snprintf(fileName, sizeof(fileName), targetName, number);
+
+        FILE *file = fopen(fileName, "wb");
+        if (file == nullptr) return false;
+
+        bool ok = (fwrite(pixels.data(), 1, pixels.size(), file) == pixels.size());
+        fclose(file);
+        return ok;
+    }
+
+    int width = 0;
+    int height = 0;
+    bool isPipe = false;
+    bool isSequence = false;
+    char targetName[512] = { 0 };
+    FILE *output = nullptr;             // Pipe or single file, null for file sequences
+
+    // Frame ring, reused for the whole recording: frame n lives in buffers[n%size], frames
+    // [written, submitted) are queued for the writer and the rest of the ring is free
+    std::vector<std::vector<unsigned char>> buffers;
+
+    std::mutex mutex;
+    std::condition_variable frameQueued;
+    std::condition_variable bufferFreed;
+    std::thread writer;                 // Started by the first Open(), lives until the destructor
+    bool stopping = false;              // Guarded by mutex
+    bool recording = false;             // Submitting thread only
+
+    int submitted = 0;                  // Guarded by mutex
+    int written = 0;
+    int stalls = 0;
+    bool failed = false;                // Writer thread only until Close() drains the queue
+};
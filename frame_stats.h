@@ -0,0 +1,119 @@
+#pragma once
+
+#include "raylib.h"
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+// Frame-time histogram with stutter detection
+// Buckets are log-linear (HDR histogram style): every power-of-two range of microseconds is
+// split in frameStatsSubBuckets linear buckets, so any recorded time is known within 1/32
+// (~3%) from 1 us up to hours, in fixed memory and O(1) per frame
+constexpr int frameStatsSubBucketBits = 5;
+constexpr int frameStatsSubBuckets = 1 << frameStatsSubBucketBits;
+constexpr int frameStatsRanges = 32;
+
+class FrameStats
+{
+public:
+    // budget: target frame time in seconds, frames slower than budget*stutterFactor are stutters
+    // and frames slower than budget*overBudgetFactor are over budget; the tolerance keeps frames
+    // paced at exactly the budget by SetTargetFPS() (vsync and timer jitter) from being counted
+    explicit FrameStats(float budget = 1.0f/60.0f, float stutterFactor = 1.5f, float overBudgetFactor = 1.05f) :
+        budget(budget), stutterFactor(stutterFactor), overBudgetFactor(overBudgetFactor) { }
+
+    void Record(float frameTime)
+    {
+        uint64_t micros = (uint64_t)(frameTime*1000000.0f);
+
+        counts[BucketIndex(micros)]++;
+        frameCount++;
+        totalTime += frameTime;
+        if (frameTime > maxTime) maxTime = frameTime;
+
+        if (frameTime > budget*overBudgetFactor)
+        {
+            overBudget++;
+            if (frameTime > budget*stutterFactor) stutters++;
+        }
+    }
+
+    // Frame time in seconds at a percentile in [0, 100], upper bound of the matching bucket
+    float Percentile(float percentile) const
+    {
+        if (frameCount == 0) return 0.0f;
+
+        uint64_t target = (uint64_t)ceil(frameCount*(double)percentile/100.0);
+        if (target == 0) target = 1;
+
+        uint64_t accumulated = 0;
+
+        for (int i = 0; i < bucketCount; i++)
+        {
+            accumulated += counts[i];
+            if (accumulated >= target)
+            {
+                float upper = BucketUpperBound(i)/1000000.0f;
+                return (upper < maxTime)? upper : maxTime;
+            }
+        }
+
+        return maxTime;
+    }
+
+    uint64_t FrameCount() const { return frameCount; }
+    uint64_t OverBudgetCount() const { return overBudget; }
+    uint64_t StutterCount() const { return stutters; }
+    float MaxTime() const { return maxTime; }
+    float AverageTime() const { return (frameCount > 0)? (float)(totalTime/frameCount) : 0.0f; }
+
+    void Reset() { *this = FrameStats(budget, stutterFactor, overBudgetFactor); }
+
+    // Summary through TraceLog(), called on shutdown right before CloseWindow()
+    void LogSummary() const
+    {
+        TraceLog(LOG_INFO, "FRAMES: %llu frames, average %.2f ms (%.1f FPS)", (unsigned long long)frameCount,
+            AverageTime()*1000.0f, (AverageTime() > 0.0f)? 1.0f/AverageTime() : 0.0f);
+        TraceLog(LOG_INFO, "FRAMES:     p50 %.2f ms | p95 %.2f ms | p99 %.2f ms | max %.2f ms",
+            Percentile(50.0f)*1000.0f, Percentile(95.0f)*1000.0f, Percentile(99.0f)*1000.0f, maxTime*1000.0f);
+        TraceLog(LOG_INFO, "FRAMES:     over budget (> %.2f ms): %llu, stutters (> %.2f ms): %llu",
+            budget*overBudgetFactor*1000.0f, (unsigned long long)overBudget, budget*stutterFactor*1000.0f, (unsigned long long)stutters);
+    }
+
+private:
+    static constexpr int bucketCount = frameStatsRanges*frameStatsSubBuckets;
+
+    static int BucketIndex(uint64_t micros)
+    {
+        // Values below one sub-bucket range map linearly, above it the top bits select the range
+        if (micros < (uint64_t)frameStatsSubBuckets) return (int)micros;
+
+        int msb = std::bit_width(micros) - 1;
+        int range = msb - frameStatsSubBucketBits + 1;
+        int sub = (int)(micros >> (range - 1)) - frameStatsSubBuckets;
+        int index = range*frameStatsSubBuckets + sub;
+
+        return (index < bucketCount)? index : bucketCount - 1;
+    }
+
+    static uint64_t BucketUpperBound(int index)
+    {
+        int range = index/frameStatsSubBuckets;
+        uint64_t sub = (uint64_t)(index%frameStatsSubBuckets);
+
+        if (range == 0) return sub + 1;
+        return ((frameStatsSubBuckets + sub + 1) << (range - 1));
+    }
+
+    float budget;
+    float stutterFactor;
+    float overBudgetFactor;
+
+    uint64_t counts[bucketCount] = {};
+    uint64_t frameCount = 0;
+    uint64_t overBudget = 0;
+    uint64_t stutters = 0;
+    double totalTime = 0.0;
+    float maxTime = 0.0f;
+};
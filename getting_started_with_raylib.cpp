@@ -1,47 +1,244 @@
 #include "raylib.h"
+#include "raymath.h"
 
-int main(void)
+#include <cstdlib>
+#include <cstring>
+
+#define ALLOC_TRACKER_IMPLEMENTATION
+#include "alloc_tracker.h"
+#include "circle_batch_renderer.h"
+#include "circle_pool.h"
+#include "circle_simulation.h"
+#include "frame_recorder.h"
+#include "frame_stats.h"
+#include "layer_compositor.h"
+#include "particle_system.h"
+#include "png_encoder_pool.h"
+#include "render_texture_utils.h"
+#include "simulation_overlays.h"
+#include "simulation_thread.h"
+#include "software_renderer.h"
+#include "text_cache.h"
+#include "thread_pool.h"
+#include "trace.h"
+
+int main(int argc, char *argv[])
 {
     // Initialization
     //--------------------------------------------------------------------------------------
     const int screenWidth = 800;
     const int screenHeight = 450;
 
+    // Headless run: getting_started_with_raylib.exe --headless [circles] [steps] [--gravity]
+    if ((argc > 1) && (strcmp(argv[1], "--headless") == 0))
+    {
+        int circleCount = (argc > 2)? atoi(argv[2]) : 20000;
+        int steps = (argc > 3)? atoi(argv[3]) : 600;
+        bool mutualGravity = (argc > 4) && (strcmp(argv[4], "--gravity") == 0);
+
+        RunHeadlessSimulation(circleCount, steps, (float)screenWidth, (float)screenHeight, mutualGravity);
+        return 0;
+    }
+
+    // GPU-less rendering: getting_started_with_raylib.exe --render [circles] [frames] [output]
+    // output: "render_%05i.png" (default), or a raw RGBA FrameRecorder target such as "|ffmpeg ..."
+    if ((argc > 1) && (strcmp(argv[1], "--render") == 0))
+    {
+        int circleCount = (argc > 2)? atoi(argv[2]) : 100000;
+        int frames = (argc > 3)? atoi(argv[3]) : 60;
+        const char *output = (argc > 4)? argv[4] : "render_%05i.png";
+
+        RunSoftwareRender(circleCount, frames, 1920, 1080, output);
+        return 0;
+    }
+
+    const int initialCircles = 100;
+    const int burstCircles = 50;
+    const int maxCircles = 10000;
+    const int maxParticles = 100000;
+    const int warmupFrames = 120;       // Frames allowed to allocate before steady state is enforced
+
     InitWindow(screenWidth, screenHeight, "raylib [core] example - basic window");
 
+    CircleSimulation sim((float)screenWidth, (float)screenHeight, maxCircles);   // Reserve up front so spawning never reallocates
+    CirclePool &circles = sim.circles;
+
+    ThreadPool pool;
+    sim.pool = &pool;
+
+    for (int i = 0; i < initialCircles; i++)
+    {
+        SpawnRandomCircle(circles, { screenWidth/2.0f, screenHeight/2.0f });
+    }
+
+    // Physics steps at a fixed 60 Hz on its own thread, this thread only draws its snapshots
+    // NOTE: From Start() on, sim is only touched through simThread commands
+    SimulationThread simThread(sim, maxCircles, 1.0f/60.0f);
+    SimulationOverlays overlays;        // Event feedback sent back by the simulation thread
+
+    // Visual-only particles, updated on this thread every frame
+    ParticleSystem particles(maxParticles);
+
+    // Static layers are only re-rendered when marked dirty, circles are drawn over them
+    LayerCompositor background;
+    background.Load(screenWidth, screenHeight);
+
+    background.AddStaticLayer([&]() {
+        ClearBackground(RAYWHITE);
+
+        for (int x = 0; x <= screenWidth; x += 25) DrawLine(x, 0, x, screenHeight, Fade(LIGHTGRAY, 0.4f));
+        for (int y = 0; y <= screenHeight; y += 25) DrawLine(0, y, screenWidth, y, Fade(LIGHTGRAY, 0.4f));
+        DrawRectangleLinesEx({ 0.0f, 0.0f, (float)screenWidth, (float)screenHeight }, 4.0f, GRAY);
+
+        // Same layer as the grid: every layer costs a full-screen quad per frame
+        DrawText("Congrats! You created your first window!", 190, 200, 20, LIGHTGRAY);
+    });
+
+    CachedText circleCounter("", 20, DARKGRAY);
+
+    // The particle count changes every frame while emitters run, its label is refreshed a few
+    // times per second so it stays a cached texture like the circle counter
+    CachedText particleCounter("", 20, DARKGRAY);
+    float particleCounterAge = 1.0f;
+
+    CircleBatchRenderer circleRenderer;
+    circleRenderer.Load();
+
+    CircleBatchRenderer particleRenderer;      // Own vertex buffer, one buffer update per frame each
+    particleRenderer.Load();
+
     SetTargetFPS(60);               // Set our game to run at 60 frames-per-second
+
+    FrameRecorder recorder;
+    PngEncoderPool pngEncoder;
+    int screenshotCounter = 0;
+
+    int frameCounter = 0;
+    FrameStats frameStats(1.0f/60.0f);
+
+    TraceSetThreadName("Main");
+    simThread.Start();
     //--------------------------------------------------------------------------------------
 
     // Main game loop
     while (!WindowShouldClose())    // Detect window close button or ESC key
     {
+        AllocTrackerBeginFrame(frameCounter >= warmupFrames);
+
         // Update
         //----------------------------------------------------------------------------------
+        TraceScope updatePhase("Update");
+
+        if (IsKeyPressed(KEY_T)) TraceDump("trace.json");     // Dump the most recent frames timeline
+
+        // Toggle raw RGBA recording of the window, convert with:
+        // ffmpeg -f rawvideo -pix_fmt rgba -s <width>x<height> -r 60 -i recording.rgba recording.mp4
+        if (IsKeyPressed(KEY_R))
+        {
+            if (recorder.IsOpen()) recorder.Close();
+            else recorder.Open("recording.rgba", GetRenderWidth(), GetRenderHeight());
+        }
+
+        // Input is applied by the simulation thread before its next step
+        if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) simThread.Post({ SIM_COMMAND_SPAWN_BURST, GetMousePosition(), burstCircles });
+        if (IsMouseButtonPressed(MOUSE_BUTTON_RIGHT)) simThread.Post({ SIM_COMMAND_DESPAWN_HALF });
+        if (IsKeyPressed(KEY_C)) simThread.Post({ SIM_COMMAND_TOGGLE_COLLISIONS });
+        if (IsKeyPressed(KEY_B)) simThread.Post({ SIM_COMMAND_TOGGLE_BROADPHASE });
+
+        // Force fields at the mouse position: 1 attractor, 2 repulsor, 3 vortex, 0 removes them all
+        if (IsKeyPressed(KEY_ONE)) simThread.Post({ SIM_COMMAND_ADD_ATTRACTOR, GetMousePosition() });
+        if (IsKeyPressed(KEY_TWO)) simThread.Post({ SIM_COMMAND_ADD_REPULSOR, GetMousePosition() });
+        if (IsKeyPressed(KEY_THREE)) simThread.Post({ SIM_COMMAND_ADD_VORTEX, GetMousePosition() });
+        if (IsKeyPressed(KEY_ZERO)) simThread.Post({ SIM_COMMAND_CLEAR_FORCE_FIELDS });
+        if (IsKeyPressed(KEY_G)) simThread.Post({ SIM_COMMAND_TOGGLE_GRAVITY });
+
+        if (IsKeyPressed(KEY_E))
+        {
+            // Add a fountain emitter at the mouse position, hue varies per emitter
+            float hue = (float)((particles.EmitterCount()*47)%360);
+
+            ParticleEmitterDesc fountain;
+            fountain.position = GetMousePosition();
+            fountain.rate = 400.0f;
+            fountain.speedMin = 120.0f;
+            fountain.speedMax = 220.0f;
+            fountain.gravity = { 0.0f, 200.0f };
+            fountain.colors[0] = { 0.0f, ColorFromHSV(hue, 0.3f, 1.0f) };
+            fountain.colors[1] = { 0.4f, ColorFromHSV(hue, 0.8f, 0.9f) };
+            fountain.colors[2] = { 1.0f, DARKGRAY };
+            fountain.colorCount = 3;
+
+            particles.AddEmitter(fountain);
+        }
+
+        particles.Update(GetFrameTime(), &pool);
+
+        frameStats.Record(GetFrameTime());
+
+        // Latest complete step, stays valid and unchanged until the next call
+        const SimulationSnapshot &snapshot = simThread.LatestSnapshot();
+
+        updatePhase.End();
 
         // Draw
         //----------------------------------------------------------------------------------
+        TraceScope drawPhase("Draw");
+
         BeginDrawing();
 
-            ClearBackground(RAYWHITE);
+            background.Draw();
+
+            circleRenderer.Draw(snapshot.positions.data(), snapshot.radii.data(), snapshot.colors.data(), snapshot.Size(), &pool);
+            particleRenderer.Draw(particles.Positions(), particles.Radii(), particles.Colors(), particles.Size(), &pool);
+            overlays.Draw(simThread, GetFrameTime());
 
-            DrawText("Congrats! You created your first window!", 190, 200, 20, LIGHTGRAY);
+            circleCounter.SetText(TextFormat("Circles: %i | %s", (int)snapshot.Size(), snapshot.broadphaseName));
+            circleCounter.Draw(10, 10);
 
-            // TODO: Draw a circle on screen
+            particleCounterAge += GetFrameTime();
+            if (particleCounterAge >= 0.25f)
+            {
+                particleCounter.SetText(TextFormat("Particles: %i", (int)particles.Size()));
+                particleCounterAge = 0.0f;
+            }
+            particleCounter.Draw(10, 35);
 
-            // TODO: make the circle move by turning into a class with velocity and position and acceleration
+        drawPhase.End();
 
-            // TODO: make the cricle collide with the screen
+        if (IsKeyPressed(KEY_P))
+        {
+            // Encoded and written on the pool threads, the pool owns the image from here
+            int depth = pngEncoder.Submit(LoadImageFromScreen(), TextFormat("screenshot_%03i.png", screenshotCounter++));
+            TraceLog(LOG_INFO, "PNG: Screenshot queued (queue depth %i)", depth);
+        }
 
-            // TODO: make many circles that go in different directions
+        // Back buffer, read before the swap straight into the recorder ring (no per-frame allocation)
+        recorder.SubmitPixels([](unsigned char *pixels) { ReadScreenPixels(pixels, GetRenderWidth(), GetRenderHeight()); });
 
+        TraceScope endDrawingPhase("EndDrawing");    // Buffer swap and frame-rate wait
         EndDrawing();
+        endDrawingPhase.End();
         //----------------------------------------------------------------------------------
+
+        AllocTrackerEndFrame();
+        frameCounter++;
     }
 
     // De-Initialization
     //--------------------------------------------------------------------------------------
+    simThread.Stop();
+    frameStats.LogSummary();
+    recorder.Close();
+    pngEncoder.Flush();
+
+    background.Unload();
+    circleCounter.Unload();
+    particleCounter.Unload();
+    circleRenderer.Unload();
+    particleRenderer.Unload();
+
     CloseWindow();        // Close window and OpenGL context
     //--------------------------------------------------------------------------------------
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "raylib.h"
+#include "render_texture_utils.h"
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+// Composites static layers cached in screen-sized render textures
+// Each layer draw function only runs when the layer is marked dirty, otherwise the layer costs
+// one full-screen quad; dynamic content is drawn by the caller on top of Draw()
+// NOTE: Owns GPU memory, call Unload() before CloseWindow()
+class LayerCompositor
+{
+public:
+    // (Re)create the layer targets, all layers become dirty
+    void Load(int screenWidth, int screenHeight)
+    {
+        width = screenWidth;
+        height = screenHeight;
+
+        for (Layer &layer : layers)
+        {
+            if (layer.target.id > 0) UnloadRenderTexture(layer.target);
+            layer.target = LoadRenderTexture(width, height);
+            layer.dirty = true;
+        }
+    }
+
+    void Unload()
+    {
+        for (Layer &layer : layers)
+        {
+            if (layer.target.id > 0) UnloadRenderTexture(layer.target);
+            layer.target = {};
+            layer.dirty = true;
+        }
+    }
+
+    // Add a layer on top of the existing ones, returns its index
+    // NOTE: draw runs inside BeginTextureMode(), it must not start another texture mode
+    int AddStaticLayer(std::function<void()> draw)
+    {
+        Layer layer = {};
+        layer.draw = std::move(draw);
+        if (width > 0) layer.target = LoadRenderTexture(width, height);
+
+        layers.push_back(std::move(layer));
+        return (int)layers.size() - 1;
+    }
+
+    void MarkDirty(int index) { layers[index].dirty = true; }
+    void MarkAllDirty() { for (Layer &layer : layers) layer.dirty = true; }
+    void SetVisible(int index, bool visible) { layers[index].visible = visible; }
+
+    // Re-render dirty layers and draw every visible layer, bottom to top
+    void Draw()
+    {
+        for (Layer &layer : layers)
+        {
+            // Not loaded (before Load() or after Unload()), texture mode 0 would draw to the screen
+            if (layer.target.id == 0) continue;
+
+            if (layer.dirty) Render(layer);
+            if (layer.visible) DrawRenderTexturePremultiplied(layer.target, width, height, { 0.0f, 0.0f });
+        }
+    }
+
+private:
+    struct Layer
+    {
+        RenderTexture2D target;
+        std::function<void()> draw;
+        bool dirty = true;
+        bool visible = true;
+    };
+
+    void Render(Layer &layer)
+    {
+        layer.dirty = false;
+
+        BeginTextureMode(layer.target);
+            ClearBackground(BLANK);
+
+            BeginRenderTextureBlend();
+                layer.draw();
+            EndBlendMode();
+        EndTextureMode();
+    }
+
+    std::vector<Layer> layers;
+    int width = 0;
+    int height = 0;
+};
@@ -0,0 +1,328 @@
+#pragma once
+
+#include "raylib.h"
+
+#include "cpu_compute.h"
+#include "fast_math.h"
+#include "float4.h"
+#include "thread_pool.h"
+#include "trace.h"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Particle color at a point of its life, time goes from 0 (birth) to 1 (death)
+struct ColorKey
+{
+    float time;
+    Color color;
+};
+
+// Emitter settings, copied when the emitter is added
+struct ParticleEmitterDesc
+{
+    Vector2 position = { 0.0f, 0.0f };
+    float rate = 100.0f;                // Particles per second
+    float direction = -PI/2.0f;         // Cone axis (radians), -PI/2 points up the screen
+    float spread = PI/8.0f;             // Cone half angle (radians)
+    float speedMin = 50.0f;
+    float speedMax = 150.0f;
+    float lifetimeMin = 1.0f;           // Seconds
+    float lifetimeMax = 2.0f;
+    float sizeStart = 4.0f;             // Radius at birth, interpolated linearly to sizeEnd at death
+    float sizeEnd = 1.0f;
+    Vector2 gravity = { 0.0f, 0.0f };
+    ColorKey colors[4] = { { 0.0f, WHITE }, { 1.0f, WHITE } };     // Color over life, sorted by time
+    int colorCount = 2;
+    float fadeOut = 0.3f;               // Last fraction of life over which alpha goes to 0
+};
+
+// Storage binding points of the particle compute kernels
+enum ParticleBinding {
+    PARTICLE_BINDING_POSITIONS = 0,
+    PARTICLE_BINDING_VELOCITIES,
+    PARTICLE_BINDING_ACCELERATIONS,
+    PARTICLE_BINDING_AGES,
+    PARTICLE_BINDING_INVERSE_LIFETIMES,
+    PARTICLE_BINDING_SIZE_STARTS,
+    PARTICLE_BINDING_SIZE_DELTAS,
+    PARTICLE_BINDING_RADII
+};
+
+// Emitter driven particles, all emitters share one structure-of-arrays particle store
+// Update() integrates every particle with a compute kernel (one invocation per batch of four
+// particles in Float4 lanes, positions, velocities and accelerations are processed as flat float
+// arrays, two particles per Float4), removes the expired ones with swap-remove, spawns the new
+// ones and computes radius and color for drawing with a second kernel.
+// Color and fade over life are baked per emitter into a small lookup table, so a particle only
+// carries its emitter index. Storage is allocated once for capacity particles, spawns past
+// capacity are dropped
+// NOTE: Random numbers come from the system's own generator, it can run on any thread
+class ParticleSystem
+{
+public:
+    static constexpr int colorLutSize = 32;
+
+    explicit ParticleSystem(size_t capacity, size_t emitterCapacity = 256) : capacity(capacity)
+    {
+        size_t padded = (capacity + 3) & ~(size_t)3;    // Whole Float4 batches, lanes past Size() are scratch
+
+        positions.resize(padded);
+        velocities.resize(padded);
+        accelerations.resize(padded);
+        ages.resize(padded);
+        inverseLifetimes.resize(padded);
+        sizeStarts.resize(padded);
+        sizeDeltas.resize(padded);
+        emitterIndices.resize(padded);
+        radii.resize(padded);
+        colors.resize(padded);
+
+        emitters.reserve(emitterCapacity);
+    }
+
+    ParticleSystem(const ParticleSystem &) = delete;
+    ParticleSystem &operator=(const ParticleSystem &) = delete;
+
+    // Returns the emitter index, -1 when emitterCapacity emitters already exist
+    int AddEmitter(const ParticleEmitterDesc &desc)
+    {
+        if (emitters.size() == emitters.capacity()) return -1;
+
+        Emitter emitter = {};
+        emitter.desc = desc;
+        emitter.active = true;
+        BakeColors(emitter);
+
+        emitters.push_back(emitter);
+        return (int)emitters.size() - 1;
+    }
+
+    void SetEmitterPosition(int emitter, Vector2 position) { emitters[emitter].desc.position = position; }
+
+    // Inactive emitters stop spawning, their live particles finish their lifetime
+    void SetEmitterActive(int emitter, bool active) { emitters[emitter].active = active; }
+
+    size_t EmitterCount() const { return emitters.size(); }
+    size_t Size() const { return count; }
+    int DroppedCount() const { return dropped; }
+
+    void Update(float dt, ThreadPool *pool = nullptr)
+    {
+        ComputeDispatcher compute(pool);
+        compute.BindStorage(PARTICLE_BINDING_POSITIONS, positions);
+        compute.BindStorage(PARTICLE_BINDING_VELOCITIES, velocities);
+        compute.BindStorage(PARTICLE_BINDING_ACCELERATIONS, accelerations);
+        compute.BindStorage(PARTICLE_BINDING_AGES, ages);
+        compute.BindStorage(PARTICLE_BINDING_INVERSE_LIFETIMES, inverseLifetimes);
+        compute.BindStorage(PARTICLE_BINDING_SIZE_STARTS, sizeStarts);
+        compute.BindStorage(PARTICLE_BINDING_SIZE_DELTAS, sizeDeltas);
+        compute.BindStorage(PARTICLE_BINDING_RADII, radii);
+
+        Integrate(compute, dt);
+
+        {
+            TRACE_SCOPE("ParticleSpawn");
+            RemoveExpired();
+            for (Emitter &emitter : emitters) Emit(emitter, dt);
+        }
+
+        ComputeAppearance(compute);
+    }
+
+    // Drawing data, valid in [0, Size()) until the next Update()
+    const Vector2 *Positions() const { return positions.data(); }
+    const float *Radii() const { return radii.data(); }
+    const Color *Colors() const { return colors.data(); }
+
+private:
+    struct Emitter
+    {
+        ParticleEmitterDesc desc;
+        Color colorLut[colorLutSize];   // Color over life with the fade out applied
+        float pending;                  // Fractional particles carried to the next update
+        bool active;
+    };
+
+    // v += a*dt, p += v*dt, age += dt; one invocation per batch of four particles
+    void Integrate(ComputeDispatcher &compute, float dt)
+    {
+        size_t batches = (count + 3)/4;
+
+        ComputeKernel integrate { "ParticleIntegrate", { 64, 1, 1 }, [=](const ComputeInvocation &id, const ComputeBindings &buffers) {
+            size_t batch = id.globalId.x;
+            if (batch >= batches) return;
+
+            Float4 dt4 = Float4::Set1(dt);
+
+            float *p = buffers[PARTICLE_BINDING_POSITIONS].As<float>();
+            float *v = buffers[PARTICLE_BINDING_VELOCITIES].As<float>();
+            const float *a = buffers[PARTICLE_BINDING_ACCELERATIONS].As<float>();
+            float *age = buffers[PARTICLE_BINDING_AGES].As<float>();
+
+            // Four particles are eight interleaved x, y floats
+            for (size_t f = batch*8; f < batch*8 + 8; f += 4)
+            {
+                Float4 velocity = Float4::LoadUnaligned(v + f) + Float4::LoadUnaligned(a + f)*dt4;
+                velocity.StoreUnaligned(v + f);
+                (Float4::LoadUnaligned(p + f) + velocity*dt4).StoreUnaligned(p + f);
+            }
+
+            (Float4::LoadUnaligned(age + batch*4) + dt4).StoreUnaligned(age + batch*4);
+        } };
+
+        compute.Dispatch(integrate, ComputeDispatcher::GroupCount(batches, integrate.localSize.x));
+    }
+
+    void RemoveExpired()
+    {
+        size_t i = 0;
+        while (i < count)
+        {
+            if (ages[i]*inverseLifetimes[i] < 1.0f) { i++; continue; }
+
+            count--;
+            if (i != count) Move(count, i);     // Re-test i, it now holds the former last particle
+        }
+    }
+
+    void Move(size_t from, size_t to)
+    {
+        positions[to] = positions[from];
+        velocities[to] = velocities[from];
+        accelerations[to] = accelerations[from];
+        ages[to] = ages[from];
+        inverseLifetimes[to] = inverseLifetimes[from];
+        sizeStarts[to] = sizeStarts[from];
+        sizeDeltas[to] = sizeDeltas[from];
+        emitterIndices[to] = emitterIndices[from];
+    }
+
+    void Emit(Emitter &emitter, float dt)
+    {
+        if (!emitter.active) return;
+
+        const ParticleEmitterDesc &desc = emitter.desc;
+
+        emitter.pending += desc.rate*dt;
+        int spawnCount = (int)emitter.pending;
+        emitter.pending -= (float)spawnCount;
+
+        uint32_t emitterIndex = (uint32_t)(&emitter - emitters.data());
+
+        for (int k = 0; k < spawnCount; k++)
+        {
+            if (count == capacity) { dropped += spawnCount - k; return; }
+
+            float angle = desc.direction + desc.spread*RandomRange(-1.0f, 1.0f);
+            float speed = RandomRange(desc.speedMin, desc.speedMax);
+            float lifetime = RandomRange(desc.lifetimeMin, desc.lifetimeMax);
+#if defined(SIMULATION_FAST_MATH)
+            Vector2 velocity = FastVector2Rotate({ speed, 0.0f }, angle);
+#else
+            Vector2 velocity = { cosf(angle)*speed, sinf(angle)*speed };
+#endif
+            // Spread the births over the update interval, otherwise high rates emit visible clumps
+            float age = ((float)(spawnCount - 1 - k) + emitter.pending)/desc.rate;
+
+            size_t i = count++;
+            positions[i] = { desc.position.x + velocity.x*age, desc.position.y + velocity.y*age };
+            velocities[i] = velocity;
+            accelerations[i] = desc.gravity;
+            ages[i] = age;
+            inverseLifetimes[i] = 1.0f/lifetime;
+            sizeStarts[i] = desc.sizeStart;
+            sizeDeltas[i] = desc.sizeEnd - desc.sizeStart;
+            emitterIndices[i] = emitterIndex;
+        }
+    }
+
+    // Radius and color from the life fraction; one invocation per batch of four particles
+    // NOTE: Colors are looked up in the emitter tables directly, they stay out of the bindings
+    void ComputeAppearance(ComputeDispatcher &compute)
+    {
+        size_t batches = (count + 3)/4;
+
+        ComputeKernel appearance { "ParticleAppearance", { 64, 1, 1 }, [this, batches](const ComputeInvocation &id, const ComputeBindings &buffers) {
+            size_t batch = id.globalId.x;
+            if (batch >= batches) return;
+
+            size_t first = batch*4;
+            const float *age = buffers[PARTICLE_BINDING_AGES].As<float>() + first;
+            const float *inverseLifetime = buffers[PARTICLE_BINDING_INVERSE_LIFETIMES].As<float>() + first;
+            const float *sizeStart = buffers[PARTICLE_BINDING_SIZE_STARTS].As<float>() + first;
+            const float *sizeDelta = buffers[PARTICLE_BINDING_SIZE_DELTAS].As<float>() + first;
+            float *radius = buffers[PARTICLE_BINDING_RADII].As<float>() + first;
+
+            Float4 life = Min(Float4::LoadUnaligned(age)*Float4::LoadUnaligned(inverseLifetime), Float4::Set1(1.0f));
+            (Float4::LoadUnaligned(sizeStart) + Float4::LoadUnaligned(sizeDelta)*life).StoreUnaligned(radius);
+
+            alignas(16) float lutIndex[4];
+            (life*Float4::Set1((float)(colorLutSize - 1))).Store(lutIndex);
+
+            size_t lanes = (first + 4 <= count)? 4 : count - first;     // Padding lanes have no emitter
+            for (size_t lane = 0; lane < lanes; lane++)
+            {
+                colors[first + lane] = emitters[emitterIndices[first + lane]].colorLut[(int)(lutIndex[lane] + 0.5f)];
+            }
+        } };
+
+        compute.Dispatch(appearance, ComputeDispatcher::GroupCount(batches, appearance.localSize.x));
+    }
+
+    static void BakeColors(Emitter &emitter)
+    {
+        const ParticleEmitterDesc &desc = emitter.desc;
+
+        for (int j = 0; j < colorLutSize; j++)
+        {
+            float time = (float)j/(colorLutSize - 1);
+
+            // Last key at or before time, clamped to the first and last keys
+            int key = 0;
+            while ((key + 1 < desc.colorCount) && (desc.colors[key + 1].time <= time)) key++;
+
+            Color color = desc.colors[key].color;
+            if ((key + 1 < desc.colorCount) && (time > desc.colors[key].time))
+            {
+                const ColorKey &a = desc.colors[key];
+                const ColorKey &b = desc.colors[key + 1];
+                color = ColorLerp(a.color, b.color, (time - a.time)/(b.time - a.time));
+            }
+
+            if ((desc.fadeOut > 0.0f) && (time > 1.0f - desc.fadeOut)) color = ColorAlpha(color, (color.a/255.0f)*(1.0f - time)/desc.fadeOut);
+
+            emitter.colorLut[j] = color;
+        }
+    }
+
+    // xorshift32, uniform in [min, max]
+    float RandomRange(float min, float max)
+    {
+        rngState ^= rngState << 13;
+        rngState ^= rngState >> 17;
+        rngState ^= rngState << 5;
+
+        return min + (max - min)*(float)(rngState >> 8)*(1.0f/16777215.0f);
+    }
+
+    size_t capacity;
+    size_t count = 0;
+    int dropped = 0;                    // Spawns lost because the store was full
+    uint32_t rngState = 2463534242u;
+
+    // Particle structure-of-arrays, padded to whole Float4 batches
+    std::vector<Vector2> positions;
+    std::vector<Vector2> velocities;
+    std::vector<Vector2> accelerations;
+    std::vector<float> ages;
+    std::vector<float> inverseLifetimes;
+    std::vector<float> sizeStarts;
+    std::vector<float> sizeDeltas;
+    std::vector<uint32_t> emitterIndices;
+    std::vector<float> radii;           // Drawing outputs
+    std::vector<Color> colors;
+
+    std::vector<Emitter> emitters;      // Reserved up front, emitters are never removed
+};
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "raylib.h"
+
+#include "trace.h"
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Background PNG encoding for screenshots and frame dumps
+// Submit() takes ownership of an image and returns immediately; worker threads encode queued
+// images in parallel with ExportImageToMemory(), write them with SaveFileData() and unload them.
+// At most maxQueued images wait at once, past that Submit() blocks until a worker catches up
+// NOTE: Images are not copied, do not use or unload an image after submitting it
+class PngEncoderPool
+{
+public:
+    explicit PngEncoderPool(int threadCount = DefaultThreadCount(), int maxQueued = 64) : maxQueued(maxQueued)
+    {
+        for (int i = 0; i < threadCount; i++) workers.emplace_back([this]() { WorkerLoop(); });
+    }
+
+    ~PngEncoderPool()
+    {
+        Flush();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        jobQueued.notify_all();
+        for (std::thread &worker : workers) worker.join();
+
+        if (submitted > 0)
+        {
+            TraceLog(LOG_INFO, "PNG: %i images written, %i failed, max queue depth %i, %i submit stalls",
+                written, failed, maxDepth, stalls);
+        }
+    }
+
+    PngEncoderPool(const PngEncoderPool &) = delete;
+    PngEncoderPool &operator=(const PngEncoderPool &) = delete;
+
+    static int DefaultThreadCount()
+    {
+        int hardware = (int)std::thread::hardware_concurrency();
+        return (hardware > 2)? hardware/2 : 1;
+    }
+
+    // Queue an image to be written as a PNG file, returns the queue depth including this image
+    int Submit(Image image, const char *fileName)
+    {
+        Job job = { image, {} };
+        snprintf(job.fileName, sizeof(job.fileName), "%s", fileName);
+
+        int depth = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            if ((int)jobs.size() >= maxQueued)
+            {
+                stalls++;
+                TRACE_SCOPE("PngSubmitStall");
+                jobTaken.wait(lock, [&]() { return (int)jobs.size() < maxQueued; });
+            }
+
+            jobs.push_back(job);
+            submitted++;
+
+            depth = (int)jobs.size() + encoding;
+            if (depth > maxDepth) maxDepth = depth;
+        }
+        jobQueued.notify_one();
+
+        return depth;
+    }
+
+    // Images queued or being encoded
+    int QueueDepth()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return (int)jobs.size() + encoding;
+    }
+
+    // Block until every submitted image is written
+    void Flush()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        jobDone.wait(lock, [&]() { return jobs.empty() && (encoding == 0); });
+    }
+
+private:
+    struct Job
+    {
+        Image image;
+        char fileName[256];
+    };
+
+    void WorkerLoop()
+    {
+        TraceSetThreadName("PNG encoder");
+
+        for (;;)
+        {
+            Job job = {};
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                jobQueued.wait(lock, [&]() { return stopping || !jobs.empty(); });
+                if (jobs.empty()) return;
+
+                job = jobs.front();
+                jobs.pop_front();
+                encoding++;
+            }
+            jobTaken.notify_one();
+
+            bool ok = false;
+            {
+                TRACE_SCOPE("EncodePng");
+
+                int size = 0;
+                unsigned char *data = ExportImageToMemory(job.image, ".png", &size);
+                if (data != nullptr)
+                {
+                    ok = SaveFileData(job.fileName, data, size);
+                    MemFree(data);
+                }
+
+                UnloadImage(job.image);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                encoding--;
+                if (ok) written++;
+                else failed++;
+            }
+            jobDone.notify_all();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::deque<Job> jobs;
+
+    std::mutex mutex;
+    std::condition_variable jobQueued;
+    std::condition_variable jobTaken;
+    std::condition_variable jobDone;
+    bool stopping = false;
+    int maxQueued;
+
+    // Guarded by mutex
+    int encoding = 0;                   // Jobs taken by a worker and not finished yet
+    int submitted = 0;
+    int written = 0;
+    int failed = 0;
+    int maxDepth = 0;
+    int stalls = 0;
+};
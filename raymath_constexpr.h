@@ -0,0 +1,445 @@
+#pragma once
+
+// constexpr variant of the raymath Vector2/Vector3/Matrix/Quaternion functions (C++20)
+//
+// raymath functions are static inline and call sqrtf/sinf/cosf, so they cannot run at compile
+// time. The functions in namespace cx have the same names, arguments and formulas and can be
+// used to build fixed transforms and lookup tables as constexpr data:
+//
+//     constexpr Matrix screenOrtho = cx::MatrixOrtho(0, 800, 450, 0, -1, 1);
+//
+// At runtime they call the libm functions like raymath does and return the same values; when
+// constant evaluated, sqrt/sin/cos are computed in double and rounded to float, which matches
+// the libm results within 1 ulp
+
+#include "raylib.h"
+
+#include <cmath>
+#include <type_traits>
+
+namespace cx {
+
+//----------------------------------------------------------------------------------
+// Scalar functions
+//----------------------------------------------------------------------------------
+constexpr double doublePi = 3.14159265358979323846;
+
+constexpr float Sqrt(float x)
+{
+    if (!std::is_constant_evaluated()) return sqrtf(x);
+    if (x <= 0.0f) return 0.0f;
+
+    // Newton-Raphson in double from an estimate within a factor of 2, converges in < 40 steps
+    double value = x;
+    double estimate = 1.0;
+    while (estimate*estimate < value) estimate *= 2.0;
+    while (estimate*estimate > 4.0*value) estimate *= 0.5;
+
+    for (int i = 0; i < 40; i++)
+    {
+        double next = 0.5*(estimate + value/estimate);
+        if (next == estimate) break;
+        estimate = next;
+    }
+
+    return (float)estimate;
+}
+
+namespace detail {
+
+// sin(x) for x in [-PI, PI], Taylor series in double (the terms vanish below 1e-17 by n = 30)
+constexpr double SinReduced(double x)
+{
+    double term = x;
+    double sum = x;
+    double x2 = x*x;
+
+    for (int n = 1; n < 15; n++)
+    {
+        term *= -x2/((2*n)*(2*n + 1));
+        sum += term;
+    }
+
+    return sum;
+}
+
+constexpr double ReduceAngle(double x)
+{
+    double turns = x/(2.0*doublePi);
+    double rounded = (double)(long long)(turns + ((turns < 0.0)? -0.5 : 0.5));
+    return x - rounded*2.0*doublePi;
+}
+
+} // namespace detail
+
+constexpr float Sin(float x)
+{
+    if (!std::is_constant_evaluated()) return sinf(x);
+    return (float)detail::SinReduced(detail::ReduceAngle(x));
+}
+
+constexpr float Cos(float x)
+{
+    if (!std::is_constant_evaluated()) return cosf(x);
+
+    // cos(x) = sin(PI/2 - x), reduced again as the shift can leave [-PI, PI]
+    return (float)detail::SinReduced(detail::ReduceAngle(doublePi/2.0 - detail::ReduceAngle(x)));
+}
+
+constexpr float Abs(float x) { return (x < 0.0f)? -x : x; }
+
+constexpr float Clamp(float value, float min, float max)
+{
+    float result = (value < min)? min : value;
+    if (result > max) result = max;
+    return result;
+}
+
+constexpr float Lerp(float start, float end, float amount) { return start + amount*(end - start); }
+
+//----------------------------------------------------------------------------------
+// Vector2
+//----------------------------------------------------------------------------------
+constexpr Vector2 Vector2Zero() { return { 0.0f, 0.0f }; }
+constexpr Vector2 Vector2One() { return { 1.0f, 1.0f }; }
+constexpr Vector2 Vector2Add(Vector2 v1, Vector2 v2) { return { v1.x + v2.x, v1.y + v2.y }; }
+constexpr Vector2 Vector2AddValue(Vector2 v, float add) { return { v.x + add, v.y + add }; }
+constexpr Vector2 Vector2Subtract(Vector2 v1, Vector2 v2) { return { v1.x - v2.x, v1.y - v2.y }; }
+constexpr Vector2 Vector2SubtractValue(Vector2 v, float sub) { return { v.x - sub, v.y - sub }; }
+constexpr float Vector2LengthSqr(Vector2 v) { return (v.x*v.x) + (v.y*v.y); }
+constexpr float Vector2Length(Vector2 v) { return Sqrt((v.x*v.x) + (v.y*v.y)); }
+constexpr float Vector2DotProduct(Vector2 v1, Vector2 v2) { return (v1.x*v2.x + v1.y*v2.y); }
+constexpr float Vector2DistanceSqr(Vector2 v1, Vector2 v2) { return ((v1.x - v2.x)*(v1.x - v2.x) + (v1.y - v2.y)*(v1.y - v2.y)); }
+constexpr float Vector2Distance(Vector2 v1, Vector2 v2) { return Sqrt((v1.x - v2.x)*(v1.x - v2.x) + (v1.y - v2.y)*(v1.y - v2.y)); }
+constexpr Vector2 Vector2Scale(Vector2 v, float scale) { return { v.x*scale, v.y*scale }; }
+constexpr Vector2 Vector2Multiply(Vector2 v1, Vector2 v2) { return { v1.x*v2.x, v1.y*v2.y }; }
+constexpr Vector2 Vector2Negate(Vector2 v) { return { -v.x, -v.y }; }
+constexpr Vector2 Vector2Divide(Vector2 v1, Vector2 v2) { return { v1.x/v2.x, v1.y/v2.y }; }
+
+constexpr Vector2 Vector2Normalize(Vector2 v)
+{
+    Vector2 result = { 0.0f, 0.0f };
+    float length = Sqrt((v.x*v.x) + (v.y*v.y));
+
+    if (length > 0)
+    {
+        float ilength = 1.0f/length;
+        result.x = v.x*ilength;
+        result.y = v.y*ilength;
+    }
+
+    return result;
+}
+
+constexpr Vector2 Vector2Transform(Vector2 v, Matrix mat)
+{
+    return { mat.m0*v.x + mat.m4*v.y + mat.m12, mat.m1*v.x + mat.m5*v.y + mat.m13 };
+}
+
+constexpr Vector2 Vector2Lerp(Vector2 v1, Vector2 v2, float amount)
+{
+    return { v1.x + amount*(v2.x - v1.x), v1.y + amount*(v2.y - v1.y) };
+}
+
+constexpr Vector2 Vector2Rotate(Vector2 v, float angle)
+{
+    float cosres = Cos(angle);
+    float sinres = Sin(angle);
+
+    return { v.x*cosres - v.y*sinres, v.x*sinres + v.y*cosres };
+}
+
+//----------------------------------------------------------------------------------
+// Vector3
+//----------------------------------------------------------------------------------
+constexpr Vector3 Vector3Zero() { return { 0.0f, 0.0f, 0.0f }; }
+constexpr Vector3 Vector3Add(Vector3 v1, Vector3 v2) { return { v1.x + v2.x, v1.y + v2.y, v1.z + v2.z }; }
+constexpr Vector3 Vector3Subtract(Vector3 v1, Vector3 v2) { return { v1.x - v2.x, v1.y - v2.y, v1.z - v2.z }; }
+constexpr Vector3 Vector3Scale(Vector3 v, float scalar) { return { v.x*scalar, v.y*scalar, v.z*scalar }; }
+constexpr float Vector3DotProduct(Vector3 v1, Vector3 v2) { return (v1.x*v2.x + v1.y*v2.y + v1.z*v2.z); }
+constexpr float Vector3Length(Vector3 v) { return Sqrt(v.x*v.x + v.y*v.y + v.z*v.z); }
+
+constexpr Vector3 Vector3CrossProduct(Vector3 v1, Vector3 v2)
+{
+    return { v1.y*v2.z - v1.z*v2.y, v1.z*v2.x - v1.x*v2.z, v1.x*v2.y - v1.y*v2.x };
+}
+
+constexpr Vector3 Vector3Normalize(Vector3 v)
+{
+    Vector3 result = v;
+    float length = Sqrt(v.x*v.x + v.y*v.y + v.z*v.z);
+
+    if (length != 0.0f)
+    {
+        float ilength = 1.0f/length;
+        result.x *= ilength;
+        result.y *= ilength;
+        result.z *= ilength;
+    }
+
+    return result;
+}
+
+constexpr Vector3 Vector3Transform(Vector3 v, Matrix mat)
+{
+    return { mat.m0*v.x + mat.m4*v.y + mat.m8*v.z + mat.m12,
+             mat.m1*v.x + mat.m5*v.y + mat.m9*v.z + mat.m13,
+             mat.m2*v.x + mat.m6*v.y + mat.m10*v.z + mat.m14 };
+}
+
+constexpr Vector3 Vector3RotateByQuaternion(Vector3 v, Quaternion q)
+{
+    Vector3 result = { 0.0f, 0.0f, 0.0f };
+
+    result.x = v.x*(q.x*q.x + q.w*q.w - q.y*q.y - q.z*q.z) + v.y*(2*q.x*q.y - 2*q.w*q.z) + v.z*(2*q.x*q.z + 2*q.w*q.y);
+    result.y = v.x*(2*q.w*q.z + 2*q.x*q.y) + v.y*(q.w*q.w - q.x*q.x + q.y*q.y - q.z*q.z) + v.z*(-2*q.w*q.x + 2*q.y*q.z);
+    result.z = v.x*(-2*q.w*q.y + 2*q.x*q.z) + v.y*(2*q.w*q.x + 2*q.y*q.z)+ v.z*(q.w*q.w - q.x*q.x - q.y*q.y + q.z*q.z);
+
+    return result;
+}
+
+//----------------------------------------------------------------------------------
+// Matrix
+//----------------------------------------------------------------------------------
+constexpr Matrix MatrixIdentity()
+{
+    return { 1.0f, 0.0f, 0.0f, 0.0f,
+             0.0f, 1.0f, 0.0f, 0.0f,
+             0.0f, 0.0f, 1.0f, 0.0f,
+             0.0f, 0.0f, 0.0f, 1.0f };
+}
+
+constexpr Matrix MatrixTranspose(Matrix mat)
+{
+    return { mat.m0, mat.m1, mat.m2, mat.m3,
+             mat.m4, mat.m5, mat.m6, mat.m7,
+             mat.m8, mat.m9, mat.m10, mat.m11,
+             mat.m12, mat.m13, mat.m14, mat.m15 };
+}
+
+constexpr Matrix MatrixMultiply(Matrix left, Matrix right)
+{
+    Matrix result = MatrixIdentity();
+
+    result.m0 = left.m0*right.m0 + left.m1*right.m4 + left.m2*right.m8 + left.m3*right.m12;
+    result.m1 = left.m0*right.m1 + left.m1*right.m5 + left.m2*right.m9 + left.m3*right.m13;
+    result.m2 = left.m0*right.m2 + left.m1*right.m6 + left.m2*right.m10 + left.m3*right.m14;
+    result.m3 = left.m0*right.m3 + left.m1*right.m7 + left.m2*right.m11 + left.m3*right.m15;
+    result.m4 = left.m4*right.m0 + left.m5*right.m4 + left.m6*right.m8 + left.m7*right.m12;
+    result.m5 = left.m4*right.m1 + left.m5*right.m5 + left.m6*right.m9 + left.m7*right.m13;
+    result.m6 = left.m4*right.m2 + left.m5*right.m6 + left.m6*right.m10 + left.m7*right.m14;
+    result.m7 = left.m4*right.m3 + left.m5*right.m7 + left.m6*right.m11 + left.m7*right.m15;
+    result.m8 = left.m8*right.m0 + left.m9*right.m4 + left.m10*right.m8 + left.m11*right.m12;
+    result.m9 = left.m8*right.m1 + left.m9*right.m5 + left.m10*right.m9 + left.m11*right.m13;
+    result.m10 = left.m8*right.m2 + left.m9*right.m6 + left.m10*right.m10 + left.m11*right.m14;
+    result.m11 = left.m8*right.m3 + left.m9*right.m7 + left.m10*right.m11 + left.m11*right.m15;
+    result.m12 = left.m12*right.m0 + left.m13*right.m4 + left.m14*right.m8 + left.m15*right.m12;
+    result.m13 = left.m12*right.m1 + left.m13*right.m5 + left.m14*right.m9 + left.m15*right.m13;
+    result.m14 = left.m12*right.m2 + left.m13*right.m6 + left.m14*right.m10 + left.m15*right.m14;
+    result.m15 = left.m12*right.m3 + left.m13*right.m7 + left.m14*right.m11 + left.m15*right.m15;
+
+    return result;
+}
+
+constexpr Matrix MatrixTranslate(float x, float y, float z)
+{
+    return { 1.0f, 0.0f, 0.0f, x,
+             0.0f, 1.0f, 0.0f, y,
+             0.0f, 0.0f, 1.0f, z,
+             0.0f, 0.0f, 0.0f, 1.0f };
+}
+
+constexpr Matrix MatrixScale(float x, float y, float z)
+{
+    return { x, 0.0f, 0.0f, 0.0f,
+             0.0f, y, 0.0f, 0.0f,
+             0.0f, 0.0f, z, 0.0f,
+             0.0f, 0.0f, 0.0f, 1.0f };
+}
+
+// NOTE: Angle must be provided in radians
+constexpr Matrix MatrixRotateZ(float angle)
+{
+    Matrix result = MatrixIdentity();
+
+    float cosres = Cos(angle);
+    float sinres = Sin(angle);
+
+    result.m0 = cosres;
+    result.m1 = sinres;
+    result.m4 = -sinres;
+    result.m5 = cosres;
+
+    return result;
+}
+
+// NOTE: Angle must be provided in radians
+constexpr Matrix MatrixRotate(Vector3 axis, float angle)
+{
+    Matrix result = MatrixIdentity();
+
+    float x = axis.x, y = axis.y, z = axis.z;
+    float lengthSquared = x*x + y*y + z*z;
+
+    if ((lengthSquared != 1.0f) && (lengthSquared != 0.0f))
+    {
+        float ilength = 1.0f/Sqrt(lengthSquared);
+        x *= ilength;
+        y *= ilength;
+        z *= ilength;
+    }
+
+    float sinres = Sin(angle);
+    float cosres = Cos(angle);
+    float t = 1.0f - cosres;
+
+    result.m0 = x*x*t + cosres;
+    result.m1 = y*x*t + z*sinres;
+    result.m2 = z*x*t - y*sinres;
+
+    result.m4 = x*y*t - z*sinres;
+    result.m5 = y*y*t + cosres;
+    result.m6 = z*y*t + x*sinres;
+
+    result.m8 = x*z*t + y*sinres;
+    result.m9 = y*z*t - x*sinres;
+    result.m10 = z*z*t + cosres;
+
+    return result;
+}
+
+constexpr Matrix MatrixOrtho(double left, double right, double bottom, double top, double nearPlane, double farPlane)
+{
+    Matrix result = MatrixIdentity();
+
+    float rl = (float)(right - left);
+    float tb = (float)(top - bottom);
+    float fn = (float)(farPlane - nearPlane);
+
+    result.m0 = 2.0f/rl;
+    result.m5 = 2.0f/tb;
+    result.m10 = -2.0f/fn;
+    result.m12 = -((float)left + (float)right)/rl;
+    result.m13 = -((float)top + (float)bottom)/tb;
+    result.m14 = -((float)farPlane + (float)nearPlane)/fn;
+
+    return result;
+}
+
+//----------------------------------------------------------------------------------
+// Quaternion
+//----------------------------------------------------------------------------------
+constexpr Quaternion QuaternionIdentity() { return { 0.0f, 0.0f, 0.0f, 1.0f }; }
+constexpr float QuaternionLength(Quaternion q) { return Sqrt(q.x*q.x + q.y*q.y + q.z*q.z + q.w*q.w); }
+
+constexpr Quaternion QuaternionNormalize(Quaternion q)
+{
+    float length = Sqrt(q.x*q.x + q.y*q.y + q.z*q.z + q.w*q.w);
+    if (length == 0.0f) length = 1.0f;
+    float ilength = 1.0f/length;
+
+    return { q.x*ilength, q.y*ilength, q.z*ilength, q.w*ilength };
+}
+
+constexpr Quaternion QuaternionMultiply(Quaternion q1, Quaternion q2)
+{
+    float qax = q1.x, qay = q1.y, qaz = q1.z, qaw = q1.w;
+    float qbx = q2.x, qby = q2.y, qbz = q2.z, qbw = q2.w;
+
+    return { qax*qbw + qaw*qbx + qay*qbz - qaz*qby,
+             qay*qbw + qaw*qby + qaz*qbx - qax*qbz,
+             qaz*qbw + qaw*qbz + qax*qby - qay*qbx,
+             qaw*qbw - qax*qbx - qay*qby - qaz*qbz };
+}
+
+// NOTE: Angle must be provided in radians
+constexpr Quaternion QuaternionFromAxisAngle(Vector3 axis, float angle)
+{
+    Quaternion result = { 0.0f, 0.0f, 0.0f, 1.0f };
+    float axisLength = Sqrt(axis.x*axis.x + axis.y*axis.y + axis.z*axis.z);
+
+    if (axisLength != 0.0f)
+    {
+        angle *= 0.5f;
+
+        float ilength = 1.0f/axisLength;
+        axis.x *= ilength;
+        axis.y *= ilength;
+        axis.z *= ilength;
+
+        float sinres = Sin(angle);
+        float cosres = Cos(angle);
+
+        result = cx::QuaternionNormalize({ axis.x*sinres, axis.y*sinres, axis.z*sinres, cosres });
+    }
+
+    return result;
+}
+
+constexpr Matrix QuaternionToMatrix(Quaternion q)
+{
+    Matrix result = MatrixIdentity();
+
+    float a2 = q.x*q.x;
+    float b2 = q.y*q.y;
+    float c2 = q.z*q.z;
+    float ac = q.x*q.z;
+    float ab = q.x*q.y;
+    float bc = q.y*q.z;
+    float ad = q.w*q.x;
+    float bd = q.w*q.y;
+    float cd = q.w*q.z;
+
+    result.m0 = 1 - 2*(b2 + c2);
+    result.m1 = 2*(ab + cd);
+    result.m2 = 2*(ac - bd);
+
+    result.m4 = 2*(ab - cd);
+    result.m5 = 1 - 2*(a2 + c2);
+    result.m6 = 2*(bc + ad);
+
+    result.m8 = 2*(ac + bd);
+    result.m9 = 2*(bc - ad);
+    result.m10 = 1 - 2*(a2 + b2);
+
+    return result;
+}
+
+//----------------------------------------------------------------------------------
+// Compile-time checks
+//----------------------------------------------------------------------------------
+// NOTE: Expected values are what raymath returns at runtime for the same arguments, calls are
+// qualified as raymath.h may be included too and argument-dependent lookup would find both
+namespace detail {
+
+constexpr bool Near(float a, float b, float tolerance = 1e-6f) { return Abs(a - b) <= tolerance; }
+
+constexpr Matrix screenOrtho = cx::MatrixOrtho(0, 800, 450, 0, -1, 1);
+static_assert((screenOrtho.m0 == 2.0f/800.0f) && (screenOrtho.m5 == -2.0f/450.0f) && (screenOrtho.m10 == -1.0f));
+static_assert((screenOrtho.m12 == -1.0f) && (screenOrtho.m13 == 1.0f) && (screenOrtho.m14 == 0.0f) && (screenOrtho.m15 == 1.0f));
+static_assert((cx::Vector2Transform({ 800.0f, 450.0f }, screenOrtho).x == 1.0f) && (cx::Vector2Transform({ 800.0f, 450.0f }, screenOrtho).y == -1.0f));
+
+static_assert(Sqrt(2.0f) == 1.41421354f);
+static_assert(Sqrt(0.0f) == 0.0f);
+static_assert(cx::Vector2Length({ 3.0f, 4.0f }) == 5.0f);
+
+static_assert(Sin(0.0f) == 0.0f);
+static_assert(Sin(PI/6.0f) == 0.5f);
+static_assert(Cos(PI/3.0f) == 0.49999997f);
+static_assert(Near(Sin(100.0f), -0.506365641f) && Near(Cos(-100.0f), 0.862318872f));
+
+constexpr Vector2 rotated = cx::Vector2Rotate({ 1.0f, 0.0f }, PI/2.0f);
+static_assert(Near(rotated.x, 0.0f) && (rotated.y == 1.0f));
+
+constexpr Matrix rotateZ = cx::MatrixRotateZ(PI/2.0f);
+constexpr Matrix rotateAxis = cx::MatrixRotate({ 0.0f, 0.0f, 2.0f }, PI/2.0f);
+constexpr Matrix fromQuaternion = cx::QuaternionToMatrix(cx::QuaternionFromAxisAngle({ 0.0f, 0.0f, 1.0f }, PI/2.0f));
+static_assert(Near(rotateZ.m0, rotateAxis.m0) && Near(rotateZ.m1, rotateAxis.m1) && Near(rotateZ.m4, rotateAxis.m4));
+static_assert(Near(rotateZ.m0, fromQuaternion.m0) && Near(rotateZ.m1, fromQuaternion.m1) && Near(rotateZ.m4, fromQuaternion.m4));
+
+constexpr Quaternion turn = cx::QuaternionMultiply(cx::QuaternionFromAxisAngle({ 0.0f, 0.0f, 1.0f }, PI/4.0f), cx::QuaternionFromAxisAngle({ 0.0f, 0.0f, 1.0f }, PI/4.0f));
+static_assert(Near(cx::Vector3RotateByQuaternion({ 1.0f, 0.0f, 0.0f }, turn).x, 0.0f) && Near(cx::Vector3RotateByQuaternion({ 1.0f, 0.0f, 0.0f }, turn).y, 1.0f));
+
+} // namespace detail
+
+} // namespace cx
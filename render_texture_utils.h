@@ -0,0 +1,53 @@
+#pragma once
+
+#include "raylib.h"
+#include "rlgl.h"
+
+#include <algorithm>
+
+// glReadPixels() is OpenGL 1.1, exported by opengl32/libGL itself; rlgl only wraps it behind
+// rlReadScreenPixels(), which allocates two screen-sized buffers per call
+#if defined(_WIN32)
+extern "C" __declspec(dllimport) void __stdcall glReadPixels(int x, int y, int width, int height, unsigned int format, unsigned int type, void *pixels);
+#else
+extern "C" void glReadPixels(int x, int y, int width, int height, unsigned int format, unsigned int type, void *pixels);
+#endif
+
+// Blend mode for drawing into a transparent render texture (BLANK background)
+// Color is stored premultiplied and alpha keeps the real coverage, so the texture can later be
+// composited with DrawRenderTexturePremultiplied() without darkened edges
+inline void BeginRenderTextureBlend(void)
+{
+    rlSetBlendFactorsSeparate(RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA, RL_ONE, RL_ONE_MINUS_SRC_ALPHA, RL_FUNC_ADD, RL_FUNC_ADD);
+    BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+}
+
+// Draw the top-left width x height area of a render texture drawn with BeginRenderTextureBlend()
+inline void DrawRenderTexturePremultiplied(RenderTexture2D target, int width, int height, Vector2 position)
+{
+    // Render textures are stored upside down, flip the source rectangle
+    Rectangle source = { 0.0f, (float)(target.texture.height - height), (float)width, -(float)height };
+
+    BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+        DrawTextureRec(target.texture, source, position, WHITE);
+    EndBlendMode();
+}
+
+// Read the bottom-left width x height area of the current framebuffer into pixels (RGBA, top row
+// first, alpha forced to 255), same result as LoadImageFromScreen() without allocating
+inline void ReadScreenPixels(unsigned char *pixels, int width, int height)
+{
+    rlDrawRenderBatchActive();      // Shapes still in the rlgl batch must reach the framebuffer first
+
+    glReadPixels(0, 0, width, height, 0x1908, 0x1401, pixels);     // GL_RGBA, GL_UNSIGNED_BYTE
+
+    // OpenGL rows start at the bottom, swap them in place
+    size_t stride = (size_t)width*4;
+    for (int y = 0; y < height/2; y++)
+    {
+        unsigned char *top = pixels + y*stride;
+        std::swap_ranges(top, top + stride, pixels + (height - 1 - y)*stride);
+    }
+
+    for (size_t i = 3; i < stride*height; i += 4) pixels[i] = 255;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "raylib.h"
+
+#include "simulation_thread.h"
+#include "trace.h"
+
+// Render side of the simulation overlay queue
+// Draw() drains every overlay the simulation emitted since the last frame into a fixed set of
+// active slots and draws them fading out over their duration; when every slot is taken the
+// oldest overlay is replaced, so a burst of events never allocates
+class SimulationOverlays
+{
+public:
+    static constexpr int maxActive = 32;
+
+    // Call between BeginDrawing() and EndDrawing(), on the thread that posts simulation commands
+    void Draw(SimulationThread &simThread, float frameTime)
+    {
+        TRACE_SCOPE("Overlays");
+
+        OverlayCommand command = {};
+        while (simThread.PopOverlay(command)) Add(command);
+
+        int textLine = 0;
+
+        for (int i = 0; i < maxActive; i++)
+        {
+            Overlay &overlay = active[i];
+            if (overlay.remaining <= 0.0f) continue;
+
+            overlay.remaining -= frameTime;
+            if (overlay.remaining <= 0.0f) continue;
+
+            float life = overlay.remaining/overlay.command.duration;    // 1 when emitted, 0 when expired
+            const OverlayCommand &c = overlay.command;
+
+            if (c.type == OVERLAY_COMMAND_RING) DrawCircleLinesV(c.position, c.radius*(2.0f - life), Fade(c.color, life));
+            else if (c.type == OVERLAY_COMMAND_TEXT)
+            {
+                DrawText(c.text, 10, GetScreenHeight() - 30 - 22*textLine, 20, Fade(c.color, (life < 0.25f)? life*4.0f : 1.0f));
+                textLine++;
+            }
+        }
+    }
+
+private:
+    struct Overlay
+    {
+        OverlayCommand command;
+        float remaining;                // Seconds left, expired at 0
+        unsigned int order;             // Emission order, the smallest is replaced first
+    };
+
+    void Add(const OverlayCommand &command)
+    {
+        int slot = 0;
+        for (int i = 0; i < maxActive; i++)
+        {
+            if (active[i].remaining <= 0.0f) { slot = i; break; }
+            if (active[i].order < active[slot].order) slot = i;
+        }
+
+        active[slot] = { command, command.duration, counter++ };
+    }
+
+    Overlay active[maxActive] = {};
+    unsigned int counter = 0;
+};
@@ -0,0 +1,274 @@
+#pragma once
+
+#include "raylib.h"
+
+#include "circle_simulation.h"
+#include "spsc_queue.h"
+#include "trace.h"
+#include "triple_buffer.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+// Input forwarded from the render thread to the simulation thread
+enum SimulationCommandType {
+    SIM_COMMAND_SPAWN_BURST = 0,        // Spawn count circles at position
+    SIM_COMMAND_DESPAWN_HALF,           // Despawn half of the circles
+    SIM_COMMAND_TOGGLE_COLLISIONS,
+    SIM_COMMAND_TOGGLE_BROADPHASE,      // Switch between uniform grid and AABB tree
+    SIM_COMMAND_ADD_ATTRACTOR,          // Force field at position
+    SIM_COMMAND_ADD_REPULSOR,
+    SIM_COMMAND_ADD_VORTEX,
+    SIM_COMMAND_CLEAR_FORCE_FIELDS,
+    SIM_COMMAND_TOGGLE_GRAVITY          // Mutual gravity between all circles
+};
+
+struct SimulationCommand
+{
+    SimulationCommandType type;
+    Vector2 position = { 0.0f, 0.0f };
+    int count = 0;
+};
+
+// Short-lived draw requests from the simulation thread to the render thread (event feedback)
+enum OverlayCommandType {
+    OVERLAY_COMMAND_RING = 0,           // Expanding circle outline at position
+    OVERLAY_COMMAND_TEXT                // Notice line at the bottom left
+};
+
+struct OverlayCommand
+{
+    OverlayCommandType type;
+    Vector2 position;
+    float radius;
+    Color color;
+    float duration;                     // Seconds the renderer keeps it, fading out
+    char text[48];                      // Fixed size, commands are copied through a lock-free ring
+};
+
+// Immutable copy of what the renderer needs from one simulation step
+struct SimulationSnapshot
+{
+    std::vector<Vector2> positions;
+    std::vector<float> radii;
+    std::vector<Color> colors;
+    const char *broadphaseName = "";
+    uint64_t step = 0;                  // Steps simulated when the snapshot was taken
+    float stepTime = 0.0f;              // Duration of the last step (seconds)
+
+    size_t Size() const { return positions.size(); }
+};
+
+// Runs a CircleSimulation at a fixed rate on its own thread
+// Every step ends with a snapshot published through a triple buffer, the render thread draws the
+// latest complete snapshot without ever waiting on physics, so a frame costs max(simulation,
+// render) instead of their sum. Input reaches the simulation as commands applied between steps
+// and overlays come back the other way, both through lock-free SPSC rings
+// NOTE: While running, the simulation (and the raylib random generator) belong to this thread;
+// Post(), LatestSnapshot() and PopOverlay() must all be called from the same (render) thread
+class SimulationThread
+{
+public:
+    SimulationThread(CircleSimulation &sim, size_t maxCircles, float stepTime = 1.0f/60.0f) : sim(sim), maxCircles(maxCircles), stepTime(stepTime)
+    {
+        // Snapshots are sized up front, steady-state steps do not allocate
+        for (int i = 0; i < 3; i++)
+        {
+            SimulationSnapshot &snapshot = snapshots.Slot(i);
+            snapshot.positions.reserve(maxCircles);
+            snapshot.radii.reserve(maxCircles);
+            snapshot.colors.reserve(maxCircles);
+        }
+    }
+
+    ~SimulationThread() { Stop(); }
+
+    SimulationThread(const SimulationThread &) = delete;
+    SimulationThread &operator=(const SimulationThread &) = delete;
+
+    void Start()
+    {
+        if (thread.joinable()) return;
+
+        // The first frame must not draw an empty scene
+        TakeSnapshot(snapshots.Back(), 0.0f);
+        snapshots.Publish();
+        snapshots.Acquire();
+
+        running = true;
+        thread = std::thread([this]() { Run(); });
+    }
+
+    void Stop()
+    {
+        if (!thread.joinable()) return;
+
+        running = false;
+        thread.join();
+
+        if (droppedCommands + droppedOverlays > 0)
+        {
+            TraceLog(LOG_WARNING, "SIM: %i commands and %i overlays dropped on full queues", droppedCommands, droppedOverlays);
+        }
+    }
+
+    // Queue a command for the next step (render thread), false if the queue is full
+    bool Post(const SimulationCommand &command)
+    {
+        if (commands.TryPush(command)) return true;
+
+        droppedCommands++;
+        return false;
+    }
+
+    // Next overlay emitted by the simulation (render thread), false when none is pending
+    bool PopOverlay(OverlayCommand &overlay) { return overlays.TryPop(overlay); }
+
+    // Latest complete snapshot, valid until the next call (render thread)
+    const SimulationSnapshot &LatestSnapshot()
+    {
+        snapshots.Acquire();
+        return snapshots.Front();
+    }
+
+private:
+    void Run()
+    {
+        TraceSetThreadName("Simulation");
+
+        auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(stepTime));
+        auto nextStep = std::chrono::steady_clock::now();
+
+        while (running)
+        {
+            auto start = std::chrono::steady_clock::now();
+
+            {
+                TRACE_SCOPE("SimulationStep");
+
+                ExecuteCommands();
+                StepSimulation(sim, stepTime);
+                stepCount++;
+            }
+
+            float elapsed = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+
+            {
+                TRACE_SCOPE("Snapshot");
+                TakeSnapshot(snapshots.Back(), elapsed);
+                snapshots.Publish();
+            }
+
+            // Fixed rate; after a long stall restart the schedule instead of running catch-up steps
+            nextStep += period;
+            auto now = std::chrono::steady_clock::now();
+            if (nextStep < now - 4*period) nextStep = now;
+            std::this_thread::sleep_until(nextStep);
+        }
+    }
+
+    void ExecuteCommands()
+    {
+        CirclePool &circles = sim.circles;
+        SimulationCommand command = {};
+
+        while (commands.TryPop(command))
+        {
+            switch (command.type)
+            {
+                case SIM_COMMAND_SPAWN_BURST:
+                {
+                    size_t before = circles.Size();
+                    for (int i = 0; (i < command.count) && (circles.Size() < maxCircles); i++) SpawnRandomCircle(circles, command.position);
+
+                    if (circles.Size() > before) EmitOverlay({ OVERLAY_COMMAND_RING, command.position, 40.0f, SKYBLUE, 0.5f, "" });
+                    else EmitText(RED, "Circle limit reached (%i)", (int)maxCircles);
+                } break;
+                case SIM_COMMAND_DESPAWN_HALF:
+                {
+                    // Iterate backwards since despawn swap-removes
+                    size_t despawned = circles.Size()/2;
+                    for (size_t i = despawned; i > 0; i--) circles.DespawnAt(i - 1);
+
+                    EmitText(DARKGRAY, "Despawned %i circles", (int)despawned);
+                } break;
+                case SIM_COMMAND_TOGGLE_COLLISIONS:
+                {
+                    sim.collisions = !sim.collisions;
+                    EmitText(DARKGRAY, "Collisions %s", sim.collisions? "on" : "off");
+                } break;
+                case SIM_COMMAND_TOGGLE_BROADPHASE:
+                {
+                    sim.broadphase = (sim.broadphase == &sim.grid)? (Broadphase *)&sim.tree : (Broadphase *)&sim.grid;
+                    EmitText(DARKGRAY, "Broadphase: %s", sim.broadphase->Name());
+                } break;
+                case SIM_COMMAND_ADD_ATTRACTOR:
+                case SIM_COMMAND_ADD_REPULSOR:
+                case SIM_COMMAND_ADD_VORTEX:
+                {
+                    ForceField field = { FORCE_FIELD_POINT, command.position, { 0.0f, 0.0f }, 600.0f, 250.0f };
+                    if (command.type == SIM_COMMAND_ADD_REPULSOR) field.strength = -600.0f;
+                    else if (command.type == SIM_COMMAND_ADD_VORTEX) field = { FORCE_FIELD_VORTEX, command.position, { 0.0f, 0.0f }, 400.0f, 200.0f };
+
+                    sim.forces.Add(field);
+                    EmitOverlay({ OVERLAY_COMMAND_RING, command.position, field.radius, (field.strength > 0.0f)? DARKGREEN : MAROON, 1.0f, "" });
+                } break;
+                case SIM_COMMAND_CLEAR_FORCE_FIELDS:
+                {
+                    EmitText(DARKGRAY, "Removed %i force fields", (int)sim.forces.Count());
+                    sim.forces.Clear();
+                } break;
+                case SIM_COMMAND_TOGGLE_GRAVITY:
+                {
+                    sim.mutualGravity = !sim.mutualGravity;
+                    EmitText(DARKGRAY, "Mutual gravity %s", sim.mutualGravity? "on" : "off");
+                } break;
+                default: break;
+            }
+        }
+    }
+
+    // Overlays are feedback only, they are dropped rather than stalling a step when the renderer lags
+    void EmitOverlay(const OverlayCommand &overlay)
+    {
+        if (!overlays.TryPush(overlay)) droppedOverlays++;
+    }
+
+    template <typename... Args>
+    void EmitText(Color color, const char *format, Args... args)
+    {
+        OverlayCommand overlay = { OVERLAY_COMMAND_TEXT, { 0.0f, 0.0f }, 0.0f, color, 2.0f, "" };
+        snprintf(overlay.text, sizeof(overlay.text), format, args...);
+        EmitOverlay(overlay);
+    }
+
+    void TakeSnapshot(SimulationSnapshot &snapshot, float elapsed) const
+    {
+        const CirclePool &circles = sim.circles;
+
+        snapshot.positions.assign(circles.positions.begin(), circles.positions.end());
+        snapshot.radii.assign(circles.radii.begin(), circles.radii.end());
+        snapshot.colors.assign(circles.colors.begin(), circles.colors.end());
+        snapshot.broadphaseName = sim.broadphase->Name();
+        snapshot.step = stepCount;
+        snapshot.stepTime = elapsed;
+    }
+
+    CircleSimulation &sim;
+    size_t maxCircles;
+    float stepTime;
+
+    TripleBuffer<SimulationSnapshot> snapshots;
+    SpscQueue<SimulationCommand, 256> commands;         // Render thread -> simulation thread
+    SpscQueue<OverlayCommand, 256> overlays;            // Simulation thread -> render thread
+    int droppedCommands = 0;                            // Render thread only
+    int droppedOverlays = 0;                            // Simulation thread only while running
+
+    std::thread thread;
+    std::atomic<bool> running { false };
+    uint64_t stepCount = 0;
+};
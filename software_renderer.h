@@ -0,0 +1,201 @@
+#pragma once
+
+#include "raylib.h"
+
+#include "circle_pool.h"
+#include "circle_simulation.h"
+#include "frame_recorder.h"
+#include "png_encoder_pool.h"
+#include "thread_pool.h"
+#include "tile_rasterizer.h"
+#include "trace.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+// CPU rendering backend, draws into an Image without a window or a GPU
+// Circles go through the binned TileRasterizer, tiles are rendered in parallel and every tile
+// composites its circles in pool order, so overlaps match the GPU drawing order
+// NOTE: Text needs the default font, which only exists once InitWindow() loaded it
+class SoftwareRenderer
+{
+public:
+    bool antialiasing = true;           // One pixel coverage ramp on circle edges
+
+    void Load(int width, int height)
+    {
+        Unload();
+        target = GenImageColor(width, height, BLANK);
+    }
+
+    void Unload()
+    {
+        if (target.data != nullptr) UnloadImage(target);
+        target = {};
+    }
+
+    const Image &GetImage() const { return target; }
+    int Width() const { return target.width; }
+    int Height() const { return target.height; }
+
+    void Clear(Color color)
+    {
+        Color *pixels = Pixels();
+        for (int i = 0; i < target.width*target.height; i++) pixels[i] = color;
+    }
+
+    // Alpha blended rectangle, clipped to the framebuffer
+    void DrawRectangle(int x, int y, int width, int height, Color color)
+    {
+        int x0 = (x < 0)? 0 : x;
+        int y0 = (y < 0)? 0 : y;
+        int x1 = (x + width > target.width)? target.width : x + width;
+        int y1 = (y + height > target.height)? target.height : y + height;
+
+        for (int row = y0; row < y1; row++) FillSpan(row, x0, x1, color);
+    }
+
+    void DrawRectangleLines(int x, int y, int width, int height, int thickness, Color color)
+    {
+        DrawRectangle(x, y, width, thickness, color);
+        DrawRectangle(x, y + height - thickness, width, thickness, color);
+        DrawRectangle(x, y + thickness, thickness, height - 2*thickness, color);
+        DrawRectangle(x + width - thickness, y + thickness, thickness, height - 2*thickness, color);
+    }
+
+    // Draw every circle of the pool, world position p lands on pixel p*scale + offset
+    void DrawCircles(const CirclePool &circles, float scale, Vector2 offset, ThreadPool *pool = nullptr)
+    {
+        rasterizer.antialiasing = antialiasing;
+        rasterizer.DrawCircles(target, circles, scale, offset, pool);
+    }
+
+    void DrawText(const char *text, int x, int y, int fontSize, Color color)
+    {
+        if (IsWindowReady()) ImageDrawText(&target, text, x, y, fontSize, color);
+    }
+
+    bool Export(const char *fileName) const { return ExportImage(target, fileName); }
+
+private:
+    Color *Pixels() { return (Color *)target.data; }
+
+    // Blend color over pixels [x0, x1) of a row (straight alpha, like BLEND_ALPHA)
+    void FillSpan(int y, int x0, int x1, Color color)
+    {
+        Color *row = Pixels() + (size_t)y*target.width;
+
+        if (color.a == 255)
+        {
+            for (int x = x0; x < x1; x++) row[x] = color;
+            return;
+        }
+
+        int alpha = color.a;
+        int inverse = 255 - alpha;
+
+        for (int x = x0; x < x1; x++)
+        {
+            Color &dst = row[x];
+            dst.r = (unsigned char)((color.r*alpha + dst.r*inverse + 127)/255);
+            dst.g = (unsigned char)((color.g*alpha + dst.g*inverse + 127)/255);
+            dst.b = (unsigned char)((color.b*alpha + dst.b*inverse + 127)/255);
+            dst.a = (unsigned char)(alpha + (dst.a*inverse + 127)/255);
+        }
+    }
+
+    Image target = {};
+    TileRasterizer rasterizer;
+};
+
+// Same scene as the window: background grid, border and the circles, world scaled to the frame
+inline void DrawSimulationSoftware(SoftwareRenderer &renderer, const CircleSimulation &sim, ThreadPool *pool)
+{
+    int width = renderer.Width();
+    int height = renderer.Height();
+    float scale = fminf(width/sim.width, height/sim.height);
+    Color gridColor = Fade(LIGHTGRAY, 0.4f);
+
+    renderer.Clear(RAYWHITE);
+
+    for (int x = 0; x <= width; x += 25) renderer.DrawRectangle(x, 0, 1, height, gridColor);
+    for (int y = 0; y <= height; y += 25) renderer.DrawRectangle(0, y, width, 1, gridColor);
+    renderer.DrawRectangleLines(0, 0, width, height, 4, GRAY);
+
+    renderer.DrawCircles(sim.circles, scale, { 0.0f, 0.0f }, pool);
+}
+
+// Simulate and render frames without a window
+// output is either a printf pattern ending in .png with one frame number conversion, e.g.
+// "render_%05i.png" (frames encoded on a PngEncoderPool), or any FrameRecorder target, streamed
+// as raw RGBA from the recorder thread
+// NOTE: One 60 Hz simulation step per frame, the world is sized like RunHeadlessSimulation()
+inline void RunSoftwareRender(int circleCount, int frames, int width, int height, const char *output)
+{
+    if (frames <= 0) return;
+
+    size_t outputLength = strlen(output);
+    bool exportPng = (outputLength > 4) && (strcmp(output + outputLength - 4, ".png") == 0);
+
+    // The name is the format of every frame file name, without a single frame number frames would
+    // overwrite each other or read missing arguments
+    if (exportPng && !IsFrameNumberPattern(output))
+    {
+        TraceLog(LOG_WARNING, "RENDER: %s must contain exactly one frame number conversion (e.g. render_%%05i.png)", output);
+        return;
+    }
+
+    Vector2 world = HeadlessWorldSize(circleCount, 800.0f, 800.0f*height/width);
+
+    ThreadPool pool;
+    CircleSimulation sim(world.x, world.y, circleCount);
+    sim.pool = &pool;
+    SpawnHeadlessCircles(sim, circleCount);
+
+    SoftwareRenderer renderer;
+    renderer.Load(width, height);
+
+    FrameRecorder recorder;
+    if (!exportPng && !recorder.Open(output, width, height)) return;
+
+    PngEncoderPool pngEncoder(exportPng? PngEncoderPool::DefaultThreadCount() : 0);
+
+    double renderTime = 0.0;
+    double exportTime = 0.0;
+
+    for (int frame = 0; frame < frames; frame++)
+    {
+        StepSimulation(sim, 1.0f/60.0f);
+
+        auto start = std::chrono::steady_clock::now();
+        {
+            TRACE_SCOPE("SoftwareRender");
+            DrawSimulationSoftware(renderer, sim, &pool);
+        }
+        auto rendered = std::chrono::steady_clock::now();
+
+        if (exportPng)
+        {
+            char fileName[256];
+            snprintf(fileName, sizeof(fileName), output, frame);
+            pngEncoder.Submit(ImageCopy(renderer.GetImage()), fileName);    // The framebuffer is reused next frame
+        }
+        else recorder.Submit(renderer.GetImage());
+
+        renderTime += std::chrono::duration<double>(rendered - start).count();
+        exportTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - rendered).count();
+    }
+
+    TraceLog(LOG_INFO, "RENDER: %i circles at %ix%i, %i frames (%.3f ms/frame render, %.3f ms/frame export, %i threads)",
+        circleCount, width, height, frames, renderTime*1000.0/frames, exportTime*1000.0/frames, pool.ThreadCount());
+
+    {
+        TRACE_SCOPE("FlushOutput");
+        recorder.Close();
+        pngEncoder.Flush();
+    }
+
+    renderer.Unload();
+}
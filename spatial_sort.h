@@ -0,0 +1,96 @@
+#pragma once
+
+#include "raylib.h"
+
+#include "circle_pool.h"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Spread the low 16 bits of v to the even bits of the result
+inline uint32_t MortonSpreadBits(uint32_t v)
+{
+    v &= 0x0000ffff;
+    v = (v | (v << 8)) & 0x00ff00ff;
+    v = (v | (v << 4)) & 0x0f0f0f0f;
+    v = (v | (v << 2)) & 0x33333333;
+    v = (v | (v << 1)) & 0x55555555;
+    return v;
+}
+
+// Z-order code of a grid cell, x in the even bits and y in the odd bits
+inline uint32_t MortonEncode(uint32_t x, uint32_t y)
+{
+    return MortonSpreadBits(x) | (MortonSpreadBits(y) << 1);
+}
+
+// LSD radix sort of (keys, order) by key, 8 bits per pass, skipping passes where all keys agree
+// keysScratch and orderScratch are working buffers, kept by the caller so repeated sorts do not allocate
+inline void RadixSortByKey(std::vector<uint32_t> &keys, std::vector<uint32_t> &order, std::vector<uint32_t> &keysScratch, std::vector<uint32_t> &orderScratch)
+{
+    size_t count = keys.size();
+    if (count == 0) return;
+
+    keysScratch.resize(count);
+    orderScratch.resize(count);
+
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        uint32_t histogram[257] = {};
+        for (size_t i = 0; i < count; i++) histogram[((keys[i] >> shift) & 0xff) + 1]++;
+
+        if (histogram[((keys[0] >> shift) & 0xff) + 1] == count) continue;
+
+        for (int b = 1; b < 257; b++) histogram[b] += histogram[b - 1];
+
+        for (size_t i = 0; i < count; i++)
+        {
+            uint32_t destination = histogram[(keys[i] >> shift) & 0xff]++;
+            keysScratch[destination] = keys[i];
+            orderScratch[destination] = order[i];
+        }
+
+        keys.swap(keysScratch);
+        order.swap(orderScratch);
+    }
+}
+
+// Reorders circles along a Morton curve of their grid cell, so circles close in space are close
+// in memory and the broadphase and contact solver neighbor accesses stay in cache
+// NOTE: Uses the broadphase cell size (largest diameter), finer cells would not change the locality
+class SpatialSorter
+{
+public:
+    void Sort(CirclePool &circles)
+    {
+        size_t count = circles.Size();
+        if (count < 2) return;
+
+        float maxRadius = 1.0f;
+        for (size_t i = 0; i < count; i++) maxRadius = fmaxf(maxRadius, circles.radii[i]);
+        float invCellSize = 1.0f/(2.0f*maxRadius);
+
+        keys.resize(count);
+        order.resize(count);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            Vector2 position = circles.positions[i];
+            uint32_t x = (uint32_t)fmaxf(position.x*invCellSize, 0.0f);
+            uint32_t y = (uint32_t)fmaxf(position.y*invCellSize, 0.0f);
+
+            keys[i] = MortonEncode(x, y);
+            order[i] = (uint32_t)i;
+        }
+
+        RadixSortByKey(keys, order, keysScratch, orderScratch);
+        circles.Reorder(order);
+    }
+
+private:
+    std::vector<uint32_t> keys;
+    std::vector<uint32_t> order;        // Sorted position -> current dense index
+    std::vector<uint32_t> keysScratch;
+    std::vector<uint32_t> orderScratch;
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+// Lock-free bounded single producer, single consumer ring buffer
+// Storage is a fixed array inside the queue, pushing and popping never allocate. Each side owns
+// one index on its own cache line and keeps a cached copy of the other side's index, so the
+// shared lines are only read again when the queue looks full (producer) or empty (consumer)
+// NOTE: Exactly one thread may push and one thread may pop; TryPush() fails when the queue is full
+template <typename T, size_t Capacity>
+class SpscQueue
+{
+    static_assert((Capacity >= 2) && ((Capacity & (Capacity - 1)) == 0), "SpscQueue capacity must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>, "SpscQueue elements are copied without constructors");
+
+public:
+    static constexpr size_t cacheLineSize = 64;
+
+    SpscQueue() = default;
+
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    // Producer
+    bool TryPush(const T &item)
+    {
+        size_t tail = producer.tail.load(std::memory_order_relaxed);
+
+        if (tail - producer.cachedHead == Capacity)
+        {
+            producer.cachedHead = consumer.head.load(std::memory_order_acquire);
+            if (tail - producer.cachedHead == Capacity) return false;
+        }
+
+        items[tail & (Capacity - 1)] = item;
+        producer.tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer
+    bool TryPop(T &item)
+    {
+        size_t head = consumer.head.load(std::memory_order_relaxed);
+
+        if (head == consumer.cachedTail)
+        {
+            consumer.cachedTail = producer.tail.load(std::memory_order_acquire);
+            if (head == consumer.cachedTail) return false;
+        }
+
+        item = items[head & (Capacity - 1)];
+        consumer.head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Items queued, exact only when called from one of the two sides while the other is idle
+    size_t SizeApprox() const
+    {
+        return producer.tail.load(std::memory_order_acquire) - consumer.head.load(std::memory_order_acquire);
+    }
+
+    static constexpr size_t GetCapacity() { return Capacity; }
+
+private:
+    // Indices grow forever and wrap through the mask, tail - head is the item count
+    struct alignas(cacheLineSize) ProducerSide
+    {
+        std::atomic<size_t> tail { 0 };
+        size_t cachedHead = 0;
+    };
+
+    struct alignas(cacheLineSize) ConsumerSide
+    {
+        std::atomic<size_t> head { 0 };
+        size_t cachedTail = 0;
+    };
+
+    ProducerSide producer;
+    ConsumerSide consumer;
+    alignas(cacheLineSize) T items[Capacity];
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "raylib.h"
+#include "render_texture_utils.h"
+
+#include <string>
+
+// Static text rendered once into a RenderTexture2D and redrawn as a single quad
+// NOTE: DrawText() lays out and submits one quad per glyph every frame, a cached text only
+// re-renders its glyphs when SetText()/SetStyle() actually change the content
+// NOTE: Owns GPU memory, call Unload() before CloseWindow()
+class CachedText
+{
+public:
+    CachedText(const char *text, int fontSize, Color color) : text(text), fontSize(fontSize), color(color)
+    {
+        this->text.reserve(64);         // Most HUD strings fit, so updates do not reallocate
+    }
+
+    CachedText(const CachedText &) = delete;
+    CachedText &operator=(const CachedText &) = delete;
+
+    void SetText(const char *newText)
+    {
+        if (text == newText) return;
+
+        text = newText;
+        dirty = true;
+    }
+
+    void SetStyle(int newFontSize, Color newColor)
+    {
+        if ((newFontSize == fontSize) && ColorIsEqual(newColor, color)) return;
+
+        fontSize = newFontSize;
+        color = newColor;
+        dirty = true;
+    }
+
+    // Draw the cached text at (x, y), same placement as DrawText(text, x, y, fontSize, color)
+    void Draw(int x, int y)
+    {
+        if (dirty) Render();
+        if (width == 0) return;
+
+        DrawRenderTexturePremultiplied(target, width, height, { (float)x, (float)y });
+    }
+
+    void Unload()
+    {
+        if (target.id > 0) UnloadRenderTexture(target);
+        target = {};
+        dirty = true;
+    }
+
+private:
+    void Render()
+    {
+        dirty = false;
+        width = MeasureText(text.c_str(), fontSize);
+        height = fontSize;
+
+        if (width == 0) return;
+
+        // Only reallocate the target when the text outgrows it
+        if ((width > target.texture.width) || (height > target.texture.height))
+        {
+            int targetWidth = (width > target.texture.width)? width : target.texture.width;
+            int targetHeight = (height > target.texture.height)? height : target.texture.height;
+
+            if (target.id > 0) UnloadRenderTexture(target);
+            target = LoadRenderTexture(targetWidth, targetHeight);
+        }
+
+        BeginTextureMode(target);
+            ClearBackground(BLANK);
+
+            BeginRenderTextureBlend();
+                DrawText(text.c_str(), 0, 0, fontSize, color);
+            EndBlendMode();
+        EndTextureMode();
+    }
+
+    std::string text;
+    int fontSize;
+    Color color;
+
+    RenderTexture2D target = {};
+    int width = 0;
+    int height = 0;
+    bool dirty = true;
+};
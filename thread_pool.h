@@ -0,0 +1,178 @@
+#pragma once
+
+#include "trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Fixed set of worker threads running data-parallel loops
+// ParallelFor() splits [0, count) into chunks of grain elements that the workers and the calling
+// thread pull from a shared atomic counter; it returns once every chunk ran. Chunks are traced
+// under the loop name, so worker activity shows up in the frame timeline
+// Loops issued by several threads at once (e.g. render and simulation threads) share the
+// workers: every in-flight loop is on a list, idle workers take chunks from the oldest loop with
+// chunks left and each caller works on its own loop until it is done
+// NOTE: A ParallelFor() issued from inside another one runs inline on the calling thread
+class ThreadPool
+{
+public:
+    explicit ThreadPool(int workerCount = DefaultWorkerCount())
+    {
+        for (int i = 0; i < workerCount; i++) workers.emplace_back([this, i]() { WorkerLoop(i); });
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+
+        wake.notify_all();
+        for (std::thread &worker : workers) worker.join();
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    static int DefaultWorkerCount()
+    {
+        int hardware = (int)std::thread::hardware_concurrency();
+        return (hardware > 1)? hardware - 1 : 0;
+    }
+
+    int WorkerCount() const { return (int)workers.size(); }
+    int ThreadCount() const { return (int)workers.size() + 1; }    // Workers plus the calling thread
+
+    // Run body(begin, end) over [0, count) in chunks of grain elements, blocking until all ran
+    template <typename Body>
+    void ParallelFor(const char *name, size_t count, size_t grain, Body &&body)
+    {
+        if (count == 0) return;
+        if (grain == 0) grain = 1;
+
+        Job job = {};
+        job.name = name;
+        job.count = count;
+        job.grain = grain;
+        job.chunks = (count + grain - 1)/grain;
+        job.body = (void *)&body;
+        job.invoke = [](void *body, size_t begin, size_t end) { (*(std::remove_reference_t<Body> *)body)(begin, end); };
+
+        if ((job.chunks == 1) || workers.empty() || insideJob)
+        {
+            RunChunks(job);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            // Append, workers serve the oldest loop first
+            Job **tail = &jobs;
+            while (*tail != nullptr) tail = &(*tail)->next;
+            *tail = &job;
+        }
+        wake.notify_all();
+
+        insideJob = true;
+        RunChunks(job);
+        insideJob = false;
+
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&]() { return (job.finished.load() == job.chunks) && (job.users == 0); });
+
+        Job **link = &jobs;
+        while (*link != &job) link = &(*link)->next;
+        *link = job.next;
+    }
+
+private:
+    struct Job
+    {
+        const char *name;
+        size_t count;
+        size_t grain;
+        size_t chunks;
+        void *body;
+        void (*invoke)(void *body, size_t begin, size_t end);
+
+        std::atomic<size_t> nextChunk { 0 };
+        std::atomic<size_t> finished { 0 };
+        int users = 0;                  // Workers holding a pointer to the job, guarded by mutex
+        Job *next = nullptr;            // In-flight list, guarded by mutex
+    };
+
+    // Oldest in-flight loop with unclaimed chunks, called with mutex held
+    Job *FindJob() const
+    {
+        for (Job *job = jobs; job != nullptr; job = job->next)
+        {
+            if (job->nextChunk.load() < job->chunks) return job;
+        }
+
+        return nullptr;
+    }
+
+    static void RunChunks(Job &job)
+    {
+        for (size_t chunk = job.nextChunk.fetch_add(1); chunk < job.chunks; chunk = job.nextChunk.fetch_add(1))
+        {
+            size_t begin = chunk*job.grain;
+            size_t end = std::min(begin + job.grain, job.count);
+
+            {
+                TRACE_SCOPE(job.name);
+                job.invoke(job.body, begin, end);
+            }
+
+            job.finished.fetch_add(1);
+        }
+    }
+
+    void WorkerLoop(int index)
+    {
+        char name[24];                  // Fits "Worker " and any int
+        snprintf(name, sizeof(name), "Worker %i", index + 1);
+        TraceSetThreadName(name);       // Copied, the name does not need to outlive this call
+        insideJob = true;
+
+        for (;;)
+        {
+            Job *job = nullptr;
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&]() { return stopping || ((job = FindJob()) != nullptr); });
+                if (stopping) return;
+
+                job->users++;
+            }
+
+            RunChunks(*job);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                job->users--;
+            }
+            done.notify_all();
+        }
+    }
+
+    static inline thread_local bool insideJob = false;
+
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    Job *jobs = nullptr;                // In-flight loops, oldest first
+    bool stopping = false;
+};
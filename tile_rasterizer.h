@@ -0,0 +1,232 @@
+#pragma once
+
+#include "raylib.h"
+
+#include "circle_pool.h"
+#include "float4.h"
+#include "thread_pool.h"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Binned tile-parallel circle rasterizer for R8G8B8A8 images
+// Circles are first sorted into the screen tiles their bounds touch (counting sort, pool order is
+// kept inside every tile list), then every tile is rasterized by one thread: the tile pixels are
+// unpacked into planar float buffers on the stack, each circle blends four pixels per step with
+// coverage computed from the distance to its center, and the tile is packed back once
+// NOTE: Anti-aliased edges use a one pixel coverage ramp centered on the circle boundary
+class TileRasterizer
+{
+public:
+    static constexpr int tileSize = 32;             // Multiple of 4, the tile planes live on the stack (16 KB)
+
+    bool antialiasing = true;
+
+    // Draw every circle of the pool over the image, world position p lands on pixel p*scale + offset
+    void DrawCircles(Image &image, const CirclePool &circles, float scale, Vector2 offset, ThreadPool *pool = nullptr)
+    {
+        width = image.width;
+        height = image.height;
+        tilesX = (width + tileSize - 1)/tileSize;
+        tilesY = (height + tileSize - 1)/tileSize;
+
+        Transform(circles, scale, offset, pool);
+        Bin();
+
+        Color *pixels = (Color *)image.data;
+        auto rasterTiles = [&](size_t begin, size_t end) {
+            for (size_t tile = begin; tile < end; tile++) RasterTile(pixels, (int)tile);
+        };
+
+        if (pool != nullptr) pool->ParallelFor("RasterTiles", (size_t)tilesX*tilesY, 4, rasterTiles);
+        else rasterTiles(0, (size_t)tilesX*tilesY);
+    }
+
+private:
+    // Screen-space circles, SoA
+    void Transform(const CirclePool &circles, float scale, Vector2 offset, ThreadPool *pool)
+    {
+        size_t count = circles.Size();
+        centerX.resize(count);
+        centerY.resize(count);
+        radius.resize(count);
+
+        auto transform = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++)
+            {
+                centerX[i] = circles.positions[i].x*scale + offset.x;
+                centerY[i] = circles.positions[i].y*scale + offset.y;
+                radius[i] = circles.radii[i]*scale;
+            }
+        };
+
+        if (pool != nullptr) pool->ParallelFor("TransformCircles", count, 4096, transform);
+        else transform(0, count);
+
+        colors = circles.colors.data();
+    }
+
+    // Tile range touched by a circle (inclusive), false when it is off screen
+    bool TileBounds(size_t i, int &tx0, int &ty0, int &tx1, int &ty1) const
+    {
+        float reach = radius[i] + 0.5f;         // Half a pixel of anti-aliasing ramp
+
+        int x0 = (int)floorf(centerX[i] - reach);
+        int y0 = (int)floorf(centerY[i] - reach);
+        int x1 = (int)floorf(centerX[i] + reach);
+        int y1 = (int)floorf(centerY[i] + reach);
+        if ((x1 < 0) || (y1 < 0) || (x0 >= width) || (y0 >= height)) return false;
+
+        tx0 = (x0 < 0)? 0 : x0/tileSize;
+        ty0 = (y0 < 0)? 0 : y0/tileSize;
+        tx1 = (x1 >= width)? tilesX - 1 : x1/tileSize;
+        ty1 = (y1 >= height)? tilesY - 1 : y1/tileSize;
+        return true;
+    }
+
+    void Bin()
+    {
+        size_t tileCount = (size_t)tilesX*tilesY;
+        tileStart.assign(tileCount + 1, 0);
+
+        int tx0 = 0, ty0 = 0, tx1 = 0, ty1 = 0;
+
+        for (size_t i = 0; i < radius.size(); i++)
+        {
+            if (!TileBounds(i, tx0, ty0, tx1, ty1)) continue;
+            for (int ty = ty0; ty <= ty1; ty++)
+            {
+                for (int tx = tx0; tx <= tx1; tx++) tileStart[ty*tilesX + tx + 1]++;
+            }
+        }
+
+        for (size_t t = 1; t <= tileCount; t++) tileStart[t] += tileStart[t - 1];
+
+        tileCursor.assign(tileStart.begin(), tileStart.end() - 1);
+        tileCircles.resize(tileStart[tileCount]);
+
+        for (size_t i = 0; i < radius.size(); i++)
+        {
+            if (!TileBounds(i, tx0, ty0, tx1, ty1)) continue;
+            for (int ty = ty0; ty <= ty1; ty++)
+            {
+                for (int tx = tx0; tx <= tx1; tx++) tileCircles[tileCursor[ty*tilesX + tx]++] = (uint32_t)i;
+            }
+        }
+    }
+
+    void RasterTile(Color *pixels, int tile)
+    {
+        const int pixelCount = tileSize*tileSize;
+
+        int originX = (tile%tilesX)*tileSize;
+        int originY = (tile/tilesX)*tileSize;
+        int tileWidth = (originX + tileSize <= width)? tileSize : width - originX;
+        int tileHeight = (originY + tileSize <= height)? tileSize : height - originY;
+
+        if (tileStart[tile] == tileStart[tile + 1]) return;
+
+        // Planar RGB in [0, 255] and alpha in [0, 1]; lanes past the image edge are computed but never stored
+        alignas(16) float red[pixelCount];
+        alignas(16) float green[pixelCount];
+        alignas(16) float blue[pixelCount];
+        alignas(16) float alpha[pixelCount];
+
+        for (int y = 0; y < tileSize; y++)
+        {
+            for (int x = 0; x < tileSize; x++)
+            {
+                Color p = ((x < tileWidth) && (y < tileHeight))? pixels[(size_t)(originY + y)*width + originX + x] : BLANK;
+                red[y*tileSize + x] = p.r;
+                green[y*tileSize + x] = p.g;
+                blue[y*tileSize + x] = p.b;
+                alpha[y*tileSize + x] = p.a/255.0f;
+            }
+        }
+
+        // Coverage is clamp((r - d)*edgeScale + 0.5): a one pixel ramp, or a hard edge at d = r
+        Float4 edgeScale = Float4::Set1(antialiasing? 1.0f : 1e6f);
+        Float4 half = Float4::Set1(0.5f);
+        Float4 one = Float4::Set1(1.0f);
+        Float4 laneOffsets = Float4::Set(0.5f, 1.5f, 2.5f, 3.5f);
+
+        for (uint32_t k = tileStart[tile]; k < tileStart[tile + 1]; k++)
+        {
+            uint32_t i = tileCircles[k];
+
+            float cx = centerX[i] - originX;
+            float cy = centerY[i] - originY;
+            float r = radius[i];
+            float reach = r + 0.5f;
+
+            int x0 = (int)floorf(cx - reach);
+            int y0 = (int)floorf(cy - reach);
+            int x1 = (int)floorf(cx + reach) + 1;
+            int y1 = (int)floorf(cy + reach) + 1;
+            if (x0 < 0) x0 = 0;
+            if (y0 < 0) y0 = 0;
+            if (x1 > tileSize) x1 = tileSize;
+            if (y1 > tileSize) y1 = tileSize;
+            x0 &= ~3;                           // Whole four pixel groups, coverage is 0 outside the circle
+
+            Color color = colors[i];
+            Float4 sourceRed = Float4::Set1(color.r);
+            Float4 sourceGreen = Float4::Set1(color.g);
+            Float4 sourceBlue = Float4::Set1(color.b);
+            Float4 sourceAlpha = Float4::Set1(color.a/255.0f);
+            Float4 radius4 = Float4::Set1(r);
+
+            for (int y = y0; y < y1; y++)
+            {
+                Float4 dy = Float4::Set1((float)y + 0.5f - cy);
+                Float4 dy2 = dy*dy;
+
+                for (int x = x0; x < x1; x += 4)
+                {
+                    Float4 dx = Float4::Set1((float)x - cx) + laneOffsets;
+                    Float4 distance = Sqrt(dx*dx + dy2);
+                    Float4 a = Clamp01((radius4 - distance)*edgeScale + half)*sourceAlpha;
+
+                    // Straight alpha over, same as BLEND_ALPHA
+                    int p = y*tileSize + x;
+                    Float4 dstRed = Float4::Load(red + p);
+                    Float4 dstGreen = Float4::Load(green + p);
+                    Float4 dstBlue = Float4::Load(blue + p);
+                    Float4 dstAlpha = Float4::Load(alpha + p);
+
+                    (dstRed + (sourceRed - dstRed)*a).Store(red + p);
+                    (dstGreen + (sourceGreen - dstGreen)*a).Store(green + p);
+                    (dstBlue + (sourceBlue - dstBlue)*a).Store(blue + p);
+                    (a + dstAlpha*(one - a)).Store(alpha + p);
+                }
+            }
+        }
+
+        for (int y = 0; y < tileHeight; y++)
+        {
+            Color *row = pixels + (size_t)(originY + y)*width + originX;
+
+            for (int x = 0; x < tileWidth; x++)
+            {
+                int p = y*tileSize + x;
+                row[x] = { (unsigned char)(red[p] + 0.5f), (unsigned char)(green[p] + 0.5f),
+                           (unsigned char)(blue[p] + 0.5f), (unsigned char)(alpha[p]*255.0f + 0.5f) };
+            }
+        }
+    }
+
+    int width = 0;
+    int height = 0;
+    int tilesX = 0;
+    int tilesY = 0;
+
+    std::vector<float> centerX;
+    std::vector<float> centerY;
+    std::vector<float> radius;
+    const Color *colors = nullptr;
+
+    std::vector<uint32_t> tileStart;    // First entry of each tile in tileCircles, tileStart[tile + 1] is one past its last
+    std::vector<uint32_t> tileCursor;
+    std::vector<uint32_t> tileCircles;  // Circle indices sorted by tile, pool order inside a tile
+};
@@ -0,0 +1,213 @@
+#pragma once
+
+// Frame phase tracing exported as Chrome trace-event JSON (about://tracing, ui.perfetto.dev)
+//
+// Every thread records into its own ring buffer, writes never lock or allocate (the buffer is
+// claimed on the first event of each thread) and the buffers keep the most recent events, so
+// an intermittent spike can be dumped right after it happened. A buffer outlives its thread,
+// its events stay dumpable until a new thread claims it
+//
+// Usage:
+//     TraceSetThreadName("Main");
+//     { TRACE_SCOPE("Update"); ... }              // Records one complete event (begin + duration)
+//     TraceScope draw("Draw"); ... draw.End();    // Same, for phases that are not a C++ scope
+//     TraceDump("trace.json");                    // Write the events currently in the buffers
+
+#include "raylib.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+
+constexpr int traceMaxThreads = 64;
+constexpr uint32_t traceEventsPerThread = 1 << 16;      // Must be a power of two
+
+struct TraceEvent
+{
+    const char *name;                   // Static string, only the pointer is stored
+    int64_t start;                      // Nanoseconds since the trace epoch
+    int64_t duration;
+};
+
+struct TraceThreadBuffer
+{
+    TraceEvent events[traceEventsPerThread];
+    std::atomic<uint32_t> head { 0 };   // Total events written, the owning thread is the only writer
+    std::atomic<bool> inUse { true };   // Cleared when the owning thread exits, the buffer can be claimed again
+    char threadName[32] = "";           // Copied, the caller string may not outlive the thread
+    int threadId = 0;                   // Slot index + 1, reused along with the buffer
+};
+
+struct TraceState
+{
+    std::atomic<TraceThreadBuffer *> threads[traceMaxThreads] = {};
+    std::atomic<int> threadCount { 0 };
+    std::atomic<bool> enabled { true };
+    std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+};
+
+inline TraceState traceState;
+
+inline int64_t TraceNow(void)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - traceState.epoch).count();
+}
+
+// Claim the buffer of an exited thread, or register a new one (nullptr once traceMaxThreads
+// threads are alive at the same time)
+inline TraceThreadBuffer *TraceClaimThreadBuffer(void)
+{
+    int threadCount = traceState.threadCount.load();
+    if (threadCount > traceMaxThreads) threadCount = traceMaxThreads;
+
+    for (int t = 0; t < threadCount; t++)
+    {
+        TraceThreadBuffer *buffer = traceState.threads[t].load(std::memory_order_acquire);
+        bool expected = false;
+
+        if ((buffer != nullptr) && buffer->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire))
+        {
+            // Previous owner events would be labeled with the new thread name, drop them
+            buffer->threadName[0] = '\0';
+            buffer->head.store(0, std::memory_order_release);
+            return buffer;
+        }
+    }
+
+    int index = traceState.threadCount.fetch_add(1);
+    if (index >= traceMaxThreads) return nullptr;
+
+    // Never freed, at most traceMaxThreads buffers are ever allocated
+    TraceThreadBuffer *buffer = new TraceThreadBuffer();
+    buffer->threadId = index + 1;
+    traceState.threads[index].store(buffer, std::memory_order_release);
+
+    return buffer;
+}
+
+// Buffer of the calling thread, claimed on first use and released when the thread exits
+inline TraceThreadBuffer *TraceGetThreadBuffer(void)
+{
+    struct TraceThreadSlot
+    {
+        TraceThreadBuffer *buffer = nullptr;
+        bool registered = false;
+
+        ~TraceThreadSlot()
+        {
+            if (buffer != nullptr) buffer->inUse.store(false, std::memory_order_release);
+            buffer = nullptr;       // Events recorded later in the thread teardown are dropped
+        }
+    };
+
+    thread_local TraceThreadSlot slot;
+
+    if (!slot.registered)
+    {
+        slot.registered = true;
+        slot.buffer = TraceClaimThreadBuffer();
+    }
+
+    return slot.buffer;
+}
+
+inline void TraceSetThreadName(const char *name)
+{
+    TraceThreadBuffer *buffer = TraceGetThreadBuffer();
+    if (buffer != nullptr) snprintf(buffer->threadName, sizeof(buffer->threadName), "%s", name);
+}
+
+inline void TraceSetEnabled(bool enabled) { traceState.enabled.store(enabled, std::memory_order_relaxed); }
+
+inline void TraceRecord(const char *name, int64_t start, int64_t end)
+{
+    TraceThreadBuffer *buffer = TraceGetThreadBuffer();
+    if (buffer == nullptr) return;
+
+    uint32_t head = buffer->head.load(std::memory_order_relaxed);
+    buffer->events[head & (traceEventsPerThread - 1)] = { name, start, end - start };
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+// Records the lifetime of the scope as one event, End() closes it early
+class TraceScope
+{
+public:
+    explicit TraceScope(const char *name) : name(name)
+    {
+        if (traceState.enabled.load(std::memory_order_relaxed)) start = TraceNow();
+    }
+
+    ~TraceScope() { End(); }
+
+    void End()
+    {
+        if (start >= 0) TraceRecord(name, start, TraceNow());
+        start = -1;
+    }
+
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+    const char *name;
+    int64_t start = -1;
+};
+
+// Write the buffered events of every thread as Chrome trace JSON, returns false on I/O error
+// NOTE: Recording is paused while dumping, events (and names) of threads still running or just
+// started may be partially overwritten
+inline bool TraceDump(const char *fileName)
+{
+    FILE *file = fopen(fileName, "w");
+    if (file == nullptr)
+    {
+        TraceLog(LOG_WARNING, "TRACE: [%s] Failed to open file", fileName);
+        return false;
+    }
+
+    bool wasEnabled = traceState.enabled.exchange(false);
+    int threadCount = traceState.threadCount.load();
+    if (threadCount > traceMaxThreads) threadCount = traceMaxThreads;
+
+    int eventCount = 0;
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    for (int t = 0; t < threadCount; t++)
+    {
+        TraceThreadBuffer *buffer = traceState.threads[t].load(std::memory_order_acquire);
+        if (buffer == nullptr) continue;
+
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%i,\"args\":{\"name\":\"%s\"}}",
+            (eventCount > 0)? ",\n" : "", buffer->threadId, (buffer->threadName[0] != '\0')? buffer->threadName : "Thread");
+        eventCount++;
+
+        uint32_t head = buffer->head.load(std::memory_order_acquire);
+        uint32_t first = (head > traceEventsPerThread)? head - traceEventsPerThread : 0;
+
+        for (uint32_t i = first; i < head; i++)
+        {
+            const TraceEvent &event = buffer->events[i & (traceEventsPerThread - 1)];
+
+            fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%i,\"ts\":%.3f,\"dur\":%.3f}",
+                event.name, buffer->threadId, event.start/1000.0, event.duration/1000.0);
+            eventCount++;
+        }
+    }
+
+    fprintf(file, "\n]}\n");
+    bool success = (ferror(file) == 0);
+    fclose(file);
+
+    traceState.enabled.store(wasEnabled);
+
+    if (success) TraceLog(LOG_INFO, "TRACE: [%s] Trace written (%i events, %i threads)", fileName, eventCount, threadCount);
+    else TraceLog(LOG_WARNING, "TRACE: [%s] Failed to write trace", fileName);
+
+    return success;
+}
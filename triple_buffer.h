@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+
+// Lock-free single producer, single consumer triple buffer
+// The producer always owns a back slot to fill and the consumer a front slot to read; Publish()
+// swaps the back slot with the shared middle slot and Acquire() takes the middle slot if it holds
+// something newer. Neither side ever waits: the producer overwrites unread results and the
+// consumer keeps the last one it acquired until a newer one is published
+template <typename T>
+class TripleBuffer
+{
+public:
+    // Direct slot access, only while neither side is running (e.g. to preallocate)
+    T &Slot(int index) { return slots[index]; }
+
+    // Producer
+    T &Back() { return slots[back]; }
+
+    void Publish()
+    {
+        back = middle.exchange(back | freshBit, std::memory_order_acq_rel) & indexMask;
+    }
+
+    // Consumer: switch to the latest published slot, returns false if nothing new was published
+    bool Acquire()
+    {
+        if ((middle.load(std::memory_order_relaxed) & freshBit) == 0) return false;
+
+        front = middle.exchange(front, std::memory_order_acq_rel) & indexMask;
+        return true;
+    }
+
+    const T &Front() const { return slots[front]; }
+
+private:
+    static constexpr int indexMask = 3;
+    static constexpr int freshBit = 4;  // Set in middle when the producer published since the last Acquire()
+
+    T slots[3];
+
+    alignas(64) int back = 0;           // Producer only
+    alignas(64) std::atomic<int> middle { 1 };
+    alignas(64) int front = 2;          // Consumer only
+};
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "raylib.h"
+
+#include "broadphase.h"
+#include "circle_pool.h"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Uniform grid broadphase over the simulation area
+// Cells are as large as the biggest circle diameter, so any two touching circles live in the
+// same or in adjacent cells; circles are bucketed with a counting sort, no per-cell allocation
+// NOTE: A few large circles inflate every cell, with widely mixed radii prefer AabbTree
+class UniformGrid : public Broadphase
+{
+public:
+    const char *Name() const override { return "Uniform grid"; }
+
+    // Rebuild the grid for the current circle positions
+    void Update(const CirclePool &circles, float width, float height) override
+    {
+        size_t count = circles.Size();
+
+        float maxRadius = 1.0f;
+        for (size_t i = 0; i < count; i++) maxRadius = fmaxf(maxRadius, circles.radii[i]);
+
+        cellSize = 2.0f*maxRadius;
+        columns = (int)ceilf(width/cellSize);
+        rows = (int)ceilf(height/cellSize);
+        if (columns < 1) columns = 1;
+        if (rows < 1) rows = 1;
+
+        cellStart.assign((size_t)columns*rows + 1, 0);
+        circleCell.resize(count);
+        entries.resize(count);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            uint32_t cell = CellOf(circles.positions[i]);
+            circleCell[i] = cell;
+            cellStart[cell + 1]++;
+        }
+
+        for (size_t c = 1; c < cellStart.size(); c++) cellStart[c] += cellStart[c - 1];
+
+        // Scatter using cellCursor as running insert position
+        cellCursor.assign(cellStart.begin(), cellStart.end() - 1);
+        for (size_t i = 0; i < count; i++) entries[cellCursor[circleCell[i]]++] = (uint32_t)i;
+    }
+
+    void FindPairs(const CirclePool &circles, std::vector<CirclePair> &pairs) override
+    {
+        pairs.clear();
+
+        // Half neighborhood (same, right, and the three cells below) visits every cell pair once
+        static const int offsets[4][2] = { { 1, 0 }, { -1, 1 }, { 0, 1 }, { 1, 1 } };
+
+        for (int y = 0; y < rows; y++)
+        {
+            for (int x = 0; x < columns; x++)
+            {
+                uint32_t cell = (uint32_t)(y*columns + x);
+
+                for (uint32_t i = cellStart[cell]; i < cellStart[cell + 1]; i++)
+                {
+                    for (uint32_t j = i + 1; j < cellStart[cell + 1]; j++) TestPair(circles, entries[i], entries[j], pairs);
+                }
+
+                for (const int *offset : offsets)
+                {
+                    int nx = x + offset[0];
+                    int ny = y + offset[1];
+                    if ((nx < 0) || (nx >= columns) || (ny >= rows)) continue;
+
+                    uint32_t other = (uint32_t)(ny*columns + nx);
+
+                    for (uint32_t i = cellStart[cell]; i < cellStart[cell + 1]; i++)
+                    {
+                        for (uint32_t j = cellStart[other]; j < cellStart[other + 1]; j++) TestPair(circles, entries[i], entries[j], pairs);
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    uint32_t CellOf(Vector2 position) const
+    {
+        int x = (int)(position.x/cellSize);
+        int y = (int)(position.y/cellSize);
+
+        // Circles slightly outside the area are kept in the border cells
+        x = (x < 0)? 0 : ((x >= columns)? columns - 1 : x);
+        y = (y < 0)? 0 : ((y >= rows)? rows - 1 : y);
+
+        return (uint32_t)(y*columns + x);
+    }
+
+    float cellSize = 1.0f;
+    int columns = 0;
+    int rows = 0;
+
+    std::vector<uint32_t> cellStart;    // First entry of each cell, cellStart[cell + 1] is one past its last
+    std::vector<uint32_t> cellCursor;
+    std::vector<uint32_t> circleCell;
+    std::vector<uint32_t> entries;      // Circle indices sorted by cell
+};